@@ -1,10 +1,13 @@
 #pragma once
 
 #include "EZ-Template/drive/drive.hpp"
+#include "profiled_drive.hpp"
 
 extern Drive chassis;
+extern ProfiledDrive profiled;
 
 void drive_example();
+void profiled_drive_example();
 void turn_example();
 void drive_and_turn();
 void wait_until_change_speed();
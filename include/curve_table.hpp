@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EZ-Template/drive/drive.hpp"
+#include "api.h"
+
+/**
+ * Joystick curves for a Drive, precomputed into lookup tables.  Drive::left_curve_function() and
+ * right_curve_function() run 3 powf() each, and every drive mode calls them twice a tick.  These
+ * tables hold the same results, so a stick value becomes a single index.
+ *
+ * The tables follow live curve changes from Drive::modify_curve_with_controller().
+ */
+class CurveTable {
+ public:
+  /**
+   * Creates tables for a drive.  They are filled on the first drive call.
+   *
+   * \param drive
+   *        Drive the curves come from.
+   */
+  explicit CurveTable(Drive &drive);
+
+  /**
+   * Same as Drive::tank(), with the left curve from the table.
+   */
+  void tank();
+
+  /**
+   * Same as Drive::arcade_standard(), with both curves from the tables.
+   *
+   * \param stick_type
+   *        ez::SINGLE or ez::SPLIT control
+   */
+  void arcade_standard(e_type stick_type);
+
+  /**
+   * Same as Drive::arcade_flipped(), with both curves from the tables.
+   *
+   * \param stick_type
+   *        ez::SINGLE or ez::SPLIT control
+   */
+  void arcade_flipped(e_type stick_type);
+
+  /**
+   * Refills both tables.  Call this after changing the curve outside of the controller, like
+   * Drive::set_curve_default().
+   */
+  void rebuild();
+
+  /**
+   * Buttons the tables watch for left curve changes.  Keep these the same as
+   * Drive::set_left_curve_buttons().
+   */
+  void set_left_curve_buttons(pros::controller_digital_e_t decrease, pros::controller_digital_e_t increase);
+
+  /**
+   * Buttons the tables watch for right curve changes.  Keep these the same as
+   * Drive::set_right_curve_buttons().
+   */
+  void set_right_curve_buttons(pros::controller_digital_e_t decrease, pros::controller_digital_e_t increase);
+
+  /**
+   * Returns (int)Drive::left_curve_function(stick).
+   */
+  int left(int stick) const { return left_table[stick + 128]; }
+
+  /**
+   * Returns (int)Drive::right_curve_function(stick).
+   */
+  int right(int stick) const { return right_table[stick + 128]; }
+
+ private:
+  Drive &drive;
+  std::int16_t left_table[256];
+  std::int16_t right_table[256];
+  double left_probe = 0;
+  double right_probe = 0;
+  bool built = false;
+  bool was_pressed = false;
+  int last = 0;  // Drive mode used last tick
+  pros::controller_digital_e_t buttons[4] = {pros::E_CONTROLLER_DIGITAL_LEFT, pros::E_CONTROLLER_DIGITAL_RIGHT,
+                                             pros::E_CONTROLLER_DIGITAL_Y, pros::E_CONTROLLER_DIGITAL_A};
+  void update();
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include "okapi/squiggles/geometry/pose.hpp"
+#include "pose_estimator.hpp"
+
+/**
+ * Grid cells along each side of the field map.  72 gives cells just under 2 inches.
+ */
+#define FIELD_PLANNER_CELLS 72
+
+/**
+ * Heading bins of the search, evenly spaced around the circle.
+ */
+#define FIELD_PLANNER_HEADINGS 16
+
+/**
+ * Most map cells the footprint can reach from the center of the robot, in any direction.
+ */
+#define FIELD_PLANNER_MAX_REACH 16
+
+/**
+ * Most waypoints in a planned path, including the start and the goal.
+ */
+#define FIELD_PLANNER_MAX_WAYPOINTS 32
+
+/**
+ * Plans obstacle-free paths across the field for SplineGenerator.
+ *
+ * Field elements are added once as rectangles and circles on a grid map.  build() then works out,
+ * for each heading bin, every cell the robot's footprint would hit an element from.  The walls
+ * are checked exactly instead.  A robot can't turn away from a wall it starts against without its
+ * back corner brushing it, so within one robot length of the start or goal the corners may do that.
+ *
+ * plan() is a hybrid A* search.  Each step drives a short arc left, straight or right from a
+ * continuous pose, and the search keeps the cheapest pose for each (cell, heading bin) of a
+ * coarser grid.  The robot may also turn in place at the start.  Near the goal it tries driving
+ * straight there.  The poses found are then shortened into straight segments and the corners
+ * become the waypoints.
+ *
+ * Everything lives in fixed arrays, about 550 KB, so make the planner a global instead of a local.
+ * set_max_expansions() bounds the time plan() takes on the brain.
+ *
+ * The spline between waypoints bends around the corners instead of through them, so pad the
+ * footprint by a few inches for clearance.
+ *
+ * Poses are in the PoseEstimator field frame: x and y in inches from the center of the field,
+ * heading in degrees clockwise with 0 facing +y.
+ */
+class FieldPlanner {
+ public:
+  /**
+   * Creates a planner for an empty field.
+   *
+   * \param field_half_width
+   *        Distance from the center of the field to the inside of each wall, in inches.
+   */
+  explicit FieldPlanner(double field_half_width = 70.25);
+
+  /**
+   * Adds a rectangular field element.
+   *
+   * \param x1, y1
+   *        One corner, in inches.
+   * \param x2, y2
+   *        The opposite corner, in inches.
+   */
+  void add_rectangle(double x1, double y1, double x2, double y2);
+
+  /**
+   * Adds a round field element, like a goal.
+   *
+   * \param x, y
+   *        The center, in inches.
+   * \param radius
+   *        The radius, in inches.
+   */
+  void add_circle(double x, double y, double radius);
+
+  /**
+   * Removes every field element.
+   */
+  void clear_obstacles();
+
+  /**
+   * Sets the robot's footprint, a rectangle centered on the center of the robot.
+   *
+   * \param length
+   *        Front to back, in inches.
+   * \param width
+   *        Side to side, in inches.
+   */
+  void set_footprint(double length, double width);
+
+  /**
+   * Works out where the robot fits for each heading bin.  plan() calls this when the field or the
+   * footprint changed, call it during initialize() to keep that time out of autonomous.
+   */
+  void build();
+
+  /**
+   * Plans a path.
+   *
+   * \param start
+   *        Where the robot is.
+   * \param goal
+   *        Where the robot should end up.
+   * \param match_heading
+   *        Whether the robot has to arrive near the goal's heading.  Otherwise the goal's heading
+   *        is replaced with the direction the robot arrives from.
+   *
+   * \return True if a path was found, see get_waypoints().  If the robot has to turn in place
+   *         before it can drive off, the first waypoint has the heading to turn to.
+   */
+  bool plan(const PoseEstimator::pose &start, const PoseEstimator::pose &goal, bool match_heading = true);
+
+  /**
+   * Whether the robot fits at a pose.
+   */
+  bool is_free(const PoseEstimator::pose &pose);
+
+  /**
+   * Waypoints of the last planned path, from the start to the goal.
+   */
+  const PoseEstimator::pose *get_waypoints() const { return waypoints; }
+
+  /**
+   * Number of waypoints of the last planned path, 0 if none was found.
+   */
+  int get_waypoint_count() const { return waypoint_count; }
+
+  /**
+   * Waypoints of the last planned path for SplineGenerator: x and y in meters, yaw in radians
+   * counterclockwise from +x.
+   */
+  std::vector<squiggles::Pose> to_squiggles() const;
+
+  /**
+   * Radius of the arcs the search turns along, in inches.  Smaller fits tighter spaces, larger
+   * gives smoother paths.
+   */
+  void set_turn_radius(double inches) { turn_radius = inches; }
+
+  /**
+   * Extra cost of each turning step, in inches.  Higher gives straighter paths.
+   */
+  void set_turn_cost(double inches) { turn_cost = inches; }
+
+  /**
+   * Most states plan() expands before it gives up.  Each costs a few microseconds on the brain.
+   */
+  void set_max_expansions(int expansions) { max_expansions = expansions; }
+
+ private:
+  static const int CELL_COUNT = FIELD_PLANNER_CELLS * FIELD_PLANNER_CELLS;
+  static const int SEARCH_CELLS = FIELD_PLANNER_CELLS / 2;  // Search cells are 2 by 2 map cells
+  static const int STATE_COUNT = SEARCH_CELLS * SEARCH_CELLS * FIELD_PLANNER_HEADINGS;
+  static_assert(STATE_COUNT < 0xFFFE, "FieldPlanner states must fit in 16 bits");
+
+  int cell_of(double x, double y) const;
+  int state_of(double x, double y, double heading) const;
+  bool fits(double x, double y, double heading, bool near_ends = false) const;
+  bool line_of_sight(double x1, double y1, double x2, double y2) const;
+  void push(std::uint16_t state);
+  std::uint16_t pop();
+  void sift_up(int i);
+  void sift_down(int i);
+
+  const double half_width;
+  const double cell_size;
+  double length = 18;
+  double width = 18;
+  double turn_radius = 12;
+  double turn_cost = 1;
+  int max_expansions = STATE_COUNT;
+  bool dirty = true;
+
+  std::bitset<CELL_COUNT> occupied;
+  std::bitset<CELL_COUNT> blocked[FIELD_PLANNER_HEADINGS];  // Footprint hits an element, per heading bin
+
+  // Search scratch space, the heading is in radians
+  float cost[STATE_COUNT];
+  float priority[STATE_COUNT];
+  float state_x[STATE_COUNT];
+  float state_y[STATE_COUNT];
+  float state_heading[STATE_COUNT];
+  std::uint16_t parent[STATE_COUNT];
+  std::uint16_t heap[STATE_COUNT];
+  std::uint16_t heap_index[STATE_COUNT];
+  int heap_size = 0;
+
+  PoseEstimator::pose path_start;
+  PoseEstimator::pose path_goal;
+  PoseEstimator::pose waypoints[FIELD_PLANNER_MAX_WAYPOINTS];
+  int waypoint_count = 0;
+};
+
+/**
+ * Adds the Over Under field elements: both goals, the barriers, the elevation bar posts and the
+ * match load bars in the corners.  The goals are at either end of the y axis, and the barriers run
+ * along the x axis between the elevation bars.  Sizes are rounded to the half inch.
+ *
+ * \param planner
+ *        The planner to add them to, call build() on it afterwards.
+ * \param short_barriers
+ *        False if the robot drives over the short barriers, so they aren't obstacles.
+ */
+void add_over_under_field(FieldPlanner &planner, bool short_barriers = true);
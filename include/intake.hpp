@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "api.h"
+
+/**
+ * Captures kept for the throughput window.
+ */
+#define INTAKE_HISTORY_SIZE 16
+
+/**
+ * Intake run by an optical sensor.
+ *
+ * A task reads proximity (and hue, when a hue range is set) every tick.  The intake can stop the
+ * moment an object is captured, or index one object past the sensor and stop when it leaves, so
+ * autons wait on the object instead of a guessed delay.  Every capture is counted.
+ *
+ * The intake only drives its motors while a mode is running, so opcontrol can still set the
+ * motors directly while it is stopped.
+ */
+class Intake {
+ public:
+  /**
+   * Intake modes.
+   */
+  enum e_mode { IDLE = 0,
+                INTAKE = 1,      // Runs until stop()
+                CAPTURE = 2,     // Runs until an object is at the sensor
+                INDEX = 3,       // Runs until an object passes the sensor
+                OUTTAKE = 4 };   // Runs backwards until stop()
+
+  /**
+   * Creates an intake.  Forward spins the left motor forwards and the right motor backwards, like
+   * runIntakeForward().
+   *
+   * \param left
+   *        Left intake motor.
+   * \param right
+   *        Right intake motor.
+   * \param optical_port
+   *        Port of the optical sensor watching the intake.
+   */
+  Intake(pros::Motor &left, pros::Motor &right, std::uint8_t optical_port);
+
+  /**
+   * Runs the intake forwards.
+   *
+   * \param stop_on_capture
+   *        Stops the intake as soon as a new object reaches the sensor.  An object still at the
+   *        sensor from before doesn't count.
+   */
+  void intake(bool stop_on_capture = true);
+
+  /**
+   * Runs the intake forwards until the next object has gone past the sensor.
+   */
+  void index();
+
+  /**
+   * Runs the intake backwards.
+   */
+  void outtake();
+
+  /**
+   * Stops the intake and lets go of the motors.
+   */
+  void stop();
+
+  /**
+   * Returns the running mode.
+   */
+  e_mode get_mode() const { return mode.load(); }
+
+  /**
+   * Returns true while an object is at the sensor.
+   */
+  bool has_object() const { return present.load(); }
+
+  /**
+   * Locks the code until an object is captured after the intake was last started.  An object
+   * still at the sensor from before doesn't count.
+   *
+   * \param timeout_ms
+   *        Longest time to wait.
+   *
+   * \return True if an object arrived, false on timeout.
+   */
+  bool wait_for_object(std::uint32_t timeout_ms);
+
+  /**
+   * Locks the code until the intake stops on its own, after a capture or an index.
+   *
+   * \param timeout_ms
+   *        Longest time to wait.
+   *
+   * \return True if the intake stopped, false on timeout.
+   */
+  bool wait_until_idle(std::uint32_t timeout_ms);
+
+  /**
+   * Returns the number of objects captured since start up.
+   */
+  std::uint32_t count() const { return captures.load(); }
+
+  /**
+   * Returns objects captured per second over the last few seconds.
+   *
+   * \param window_ms
+   *        Time to average over.
+   */
+  double throughput(std::uint32_t window_ms = 5000);
+
+  /**
+   * Proximity an object has to reach to count as captured, 0 to 255.  It has to drop
+   * PROXIMITY_HYSTERESIS below this to count as gone.
+   */
+  void set_proximity_threshold(int threshold) { proximity_threshold = threshold; }
+
+  /**
+   * Only counts objects with a hue in this range, eg. one alliance color.  A range that wraps past
+   * 360 is fine, eg. 340 to 20 for red.
+   */
+  void set_hue_range(double min, double max);
+
+  /**
+   * Power the intake runs at, 0 to 127.
+   */
+  void set_speed(int power) { speed = power; }
+
+ private:
+  pros::Motor &left;
+  pros::Motor &right;
+  pros::Optical optical;
+  std::atomic<e_mode> mode{IDLE};
+  std::atomic_bool present{false};
+  std::atomic<std::uint32_t> captures{0};
+  std::atomic<std::uint32_t> start_captures{0};  // captures when a mode was last started
+  std::uint32_t capture_times[INTAKE_HISTORY_SIZE] = {0};
+  int proximity_threshold = 200;
+  bool use_hue = false;
+  double hue_min = 0;
+  double hue_max = 360;
+  int speed = 127;
+  int streak = 0;
+  pros::Mutex mutex;
+  pros::Task task;
+
+  void set_mode(e_mode new_mode);
+  void intake_task();
+};
@@ -43,6 +43,18 @@
 //#include "pros/api_legacy.h"
 #include "EZ-Template/api.hpp"
 #include "autons.hpp"
+#include "curve_table.hpp"
+#include "field_planner.hpp"
+#include "intake.hpp"
+#include "motion_profile.hpp"
+#include "pose_estimator.hpp"
+#include "profiled_drive.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "telemetry.hpp"
+#include "telemetry_stream.hpp"
+#include "vision_tracker.hpp"
+#include "wall_relocalizer.hpp"
 
 // More includes here...
 //
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * Jerk limited (S-curve) motion profile that starts and ends at rest.  Units are whatever the
+ * inputs are in, eg. inches and seconds.  With no jerk limit this is a trapezoidal profile.
+ */
+class SCurveProfile {
+ public:
+  /**
+   * Setpoint at a point in time.
+   */
+  struct state {
+    double position = 0;
+    double velocity = 0;
+    double acceleration = 0;
+  };
+
+  /**
+   * Empty profile that holds at 0.
+   */
+  SCurveProfile() = default;
+
+  /**
+   * Creates a profile.
+   *
+   * \param distance
+   *        Distance to travel, negative goes backwards.
+   * \param max_velocity
+   *        Velocity limit.
+   * \param max_acceleration
+   *        Acceleration limit, also used for deceleration.
+   * \param max_jerk
+   *        Jerk limit.  0 turns the jerk limit off.
+   */
+  SCurveProfile(double distance, double max_velocity, double max_acceleration, double max_jerk = 0);
+
+  /**
+   * Returns the setpoint at a point in time.  Before 0 this is the start, after duration() it is
+   * the end.
+   *
+   * \param t
+   *        Time since the start of the profile.
+   */
+  state sample(double t) const;
+
+  /**
+   * Returns the time the profile takes.
+   */
+  double duration() const { return start_times[7]; }
+
+  /**
+   * Returns the highest velocity the profile reaches.  This is lower than max_velocity when the
+   * distance is too short to reach it.
+   */
+  double peak_velocity() const { return peak; }
+
+ private:
+  // 7 segments: jerk up, hold acceleration, jerk down, cruise, then the same backwards
+  double jerks[7] = {0};
+  double start_times[8] = {0};
+  state starts[8];
+  double sign = 1;
+  double peak = 0;
+};
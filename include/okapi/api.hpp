@@ -48,6 +48,7 @@
 #include "okapi/api/chassis/model/xDriveModel.hpp"
 #include "okapi/impl/chassis/controller/chassisControllerBuilder.hpp"
 
+#include "okapi/api/control/async/asyncFlatMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
@@ -62,6 +63,8 @@
 #include "okapi/api/control/iterative/iterativeVelPidController.hpp"
 #include "okapi/api/control/util/controllerRunner.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/control/util/pathReplanner.hpp"
+#include "okapi/api/control/util/pathStore.hpp"
 #include "okapi/api/control/util/pidTuner.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
 #include "okapi/impl/control/async/asyncMotionProfileControllerBuilder.hpp"
@@ -71,6 +74,9 @@
 #include "okapi/impl/control/util/controllerRunnerFactory.hpp"
 #include "okapi/impl/control/util/pidTunerFactory.hpp"
 
+#include "okapi/api/odometry/fixedThreeEncoderOdometry.hpp"
+#include "okapi/api/odometry/fixedTwoEncoderOdometry.hpp"
+#include "okapi/api/odometry/imuThreeEncoderOdometry.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/odometry/odometry.hpp"
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
@@ -94,14 +100,20 @@
 #include "okapi/impl/device/rotarysensor/rotationSensor.hpp"
 
 #include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/batchAverageFilter.hpp"
 #include "okapi/api/filter/composableFilter.hpp"
 #include "okapi/api/filter/demaFilter.hpp"
+#include "okapi/api/filter/diffDriveProcessModel.hpp"
 #include "okapi/api/filter/ekfFilter.hpp"
 #include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/extendedKalmanFilter.hpp"
 #include "okapi/api/filter/filter.hpp"
+#include "okapi/api/filter/filterPipeline.hpp"
 #include "okapi/api/filter/filteredControllerInput.hpp"
 #include "okapi/api/filter/medianFilter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/filter/runningAverageFilter.hpp"
+#include "okapi/api/filter/slidingMedianFilter.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/impl/filter/velMathFactory.hpp"
 
@@ -125,7 +137,9 @@
 
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/asyncLogFile.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/matrix.hpp"
 #include "okapi/api/util/supplier.hpp"
 #include "okapi/api/util/timeUtil.hpp"
 #include "okapi/impl/util/configurableTimeUtilFactory.hpp"
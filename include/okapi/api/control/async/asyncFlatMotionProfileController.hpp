@@ -0,0 +1,679 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/pathReplanner.hpp"
+#include "okapi/api/control/util/pathStore.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+class AsyncFlatMotionProfileController
+  : public AsyncPositionController<PathStore::Handle, PathfinderPoint> {
+  public:
+  /**
+   * An AsyncMotionProfileController that names paths by integer handles instead of strings. Paths
+   * live in a PathStore, so they are converted to motor rpm when they are generated, and starting
+   * one is O(1) with no allocation: setTarget only stores the handle.
+   *
+   * Example:
+   * auto handle = profileController->generatePath({{0_ft, 0_ft, 0_deg}, {3_ft, 0_ft, 0_deg}});
+   * profileController->setTarget(handle);
+   *
+   * Paths generated with PathFollower::ramsete are followed closed-loop instead, correcting
+   * towards the path using the odometry given to setOdometry().
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param ilimits The default limits.
+   * @param imodel The chassis model to control.
+   * @param iscales The chassis dimensions.
+   * @param ipair The gearset and external ratio used on the drive motors.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncFlatMotionProfileController(
+    const TimeUtil &itimeUtil,
+    const PathfinderLimits &ilimits,
+    const std::shared_ptr<ChassisModel> &imodel,
+    const ChassisScales &iscales,
+    const AbstractMotor::GearsetRatioPair &ipair,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger())
+    : logger(ilogger),
+      limits(ilimits),
+      model(imodel),
+      scales(iscales),
+      pair(ipair),
+      timeUtil(itimeUtil),
+      store(iscales, ipair) {
+    if (ipair.ratio == 0) {
+      std::string msg("AsyncFlatMotionProfileController: The gear ratio cannot be zero! Check if "
+                      "you are using integer division.");
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+  }
+
+  AsyncFlatMotionProfileController(AsyncFlatMotionProfileController &&other) = delete;
+
+  AsyncFlatMotionProfileController &operator=(AsyncFlatMotionProfileController &&other) = delete;
+
+  ~AsyncFlatMotionProfileController() override {
+    dtorCalled.store(true, std::memory_order_release);
+    delete replanTask;
+    delete task;
+  }
+
+  /**
+   * Reserves space so generating paths up to these totals does not allocate in the store.
+   *
+   * @param ipaths The total number of paths.
+   * @param ipoints The total number of points across all paths, at 100 points per second.
+   */
+  void reserve(const std::size_t ipaths, const std::size_t ipoints) {
+    std::scoped_lock lock(currentPathMutex);
+    store.reserve(ipaths, ipoints);
+  }
+
+  /**
+   * Generates a path which intersects the given waypoints, using the default limits. Throws a
+   * std::runtime_error if the path could not be generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ifollower How the path should be followed.
+   * @return The handle for the path.
+   */
+  PathStore::Handle generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                 const PathFollower ifollower = PathFollower::openLoop) {
+    return generatePath(iwaypoints, limits, ifollower);
+  }
+
+  /**
+   * Generates a path which intersects the given waypoints. Throws a std::runtime_error if the path
+   * could not be generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for this path only.
+   * @param ifollower How the path should be followed.
+   * @return The handle for the path.
+   */
+  PathStore::Handle generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                 const PathfinderLimits &ilimits,
+                                 const PathFollower ifollower = PathFollower::openLoop) {
+    std::vector<squiggles::Pose> points;
+    points.reserve(iwaypoints.size());
+    for (auto &point : iwaypoints) {
+      points.push_back(squiggles::Pose{
+        point.x.convert(meter), point.y.convert(meter), point.theta.convert(radian)});
+    }
+
+    auto constraints = squiggles::Constraints(ilimits.maxVel, ilimits.maxAccel, ilimits.maxJerk);
+    auto generator = squiggles::SplineGenerator(
+      constraints,
+      std::make_shared<squiggles::TankModel>(scales.wheelTrack.convert(meter), constraints),
+      DT);
+
+    const auto path = generator.generate(points);
+    if (path.empty()) {
+      std::string msg("AsyncFlatMotionProfileController: Path generation failed. The waypoints "
+                      "may be unreachable under the given limits.");
+      LOG_ERROR(msg);
+      throw std::runtime_error(msg);
+    }
+
+    std::scoped_lock lock(currentPathMutex);
+    const auto handle = store.add(path, DT, ifollower);
+    LOG_INFO("AsyncFlatMotionProfileController: Generated path " + std::to_string(handle) +
+             " with " + std::to_string(path.size()) + " points");
+    return handle;
+  }
+
+  /**
+   * Removes a path. A path which is running can't be removed.
+   *
+   * @param ipathId The path to remove.
+   * @return True if the path was removed, false otherwise.
+   */
+  bool removePath(const PathStore::Handle ipathId) {
+    std::scoped_lock lock(currentPathMutex);
+    if (!isDisabled() && isRunning.load(std::memory_order_acquire) &&
+        (currentPath == ipathId || startedPath == ipathId)) {
+      LOG_WARN("AsyncFlatMotionProfileController: Attempted to remove path " +
+               std::to_string(ipathId) + " while it is running.");
+      return false;
+    }
+
+    return store.remove(ipathId);
+  }
+
+  /**
+   * Sets the odometry used to follow PathFollower::ramsete paths. Without it, those paths are
+   * followed open-loop.
+   *
+   * @param iodometry The odometry, which must be stepped elsewhere, eg. by an
+   * OdomChassisController.
+   */
+  void setOdometry(const std::shared_ptr<Odometry> &iodometry) {
+    odometry = iodometry;
+  }
+
+  /**
+   * Sets the RAMSETE gains. Larger b corrects position error more aggressively and larger zeta
+   * damps the correction more.
+   *
+   * @param ib The convergence gain, in 1/m^2. Must be greater than 0.
+   * @param izeta The damping, between 0 and 1.
+   */
+  void setRamseteGains(const double ib, const double izeta) {
+    ramseteB = ib;
+    ramseteZeta = izeta;
+  }
+
+  /**
+   * Replans PathFollower::ramsete paths from the robot's current state when it is pushed off of
+   * them. Once the robot is further than imaxError from the path, a background task connects its
+   * current state back to the path ilookahead ahead and swaps the new path in, without stopping.
+   * See PathReplanner.
+   *
+   * @param imaxError The distance from the path which causes a replan.
+   * @param ilookahead How far ahead on the path to rejoin it.
+   * @param imodel The constraints for the connection. The default is a TankModel with the
+   * default limits.
+   */
+  void enableReplanning(const QLength &imaxError,
+                        const QTime &ilookahead = 0.5_s,
+                        std::shared_ptr<squiggles::PhysicalModel> imodel = nullptr) {
+    if (!imodel) {
+      imodel = std::make_shared<squiggles::TankModel>(
+        scales.wheelTrack.convert(meter),
+        squiggles::Constraints(limits.maxVel, limits.maxAccel, limits.maxJerk));
+    }
+
+    std::scoped_lock lock(currentPathMutex);
+    replanner = std::make_shared<PathReplanner>(imodel, store, DT);
+    replanError = imaxError.convert(meter);
+    replanLookahead = static_cast<std::size_t>(ilookahead.convert(second) / DT);
+    if (!replanTask) {
+      replanTask =
+        new CrossplatformThread(replanTrampoline, this, "AsyncFlatMotionProfileController Replan");
+    }
+  }
+
+  /**
+   * @return The handles of every stored path.
+   */
+  std::vector<PathStore::Handle> getPaths() {
+    std::scoped_lock lock(currentPathMutex);
+    return store.getPaths();
+  }
+
+  /**
+   * Executes a path with the given handle. If there is no path with that handle, the controller
+   * will do nothing.
+   *
+   * @param ipathId A handle returned by generatePath.
+   */
+  void setTarget(PathStore::Handle ipathId) override {
+    setTarget(ipathId, false, false);
+  }
+
+  /**
+   * Executes a path with the given handle. If there is no path with that handle, the controller
+   * will do nothing. A path that is already running is not switched partway through: it runs to
+   * its end, then the new path starts.
+   *
+   * @param ipathId A handle returned by generatePath.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   */
+  void setTarget(PathStore::Handle ipathId, bool ibackwards, bool imirrored = false) {
+    std::scoped_lock lock(currentPathMutex);
+    if (!store.contains(ipathId)) {
+      LOG_WARN("AsyncFlatMotionProfileController: No path with handle " + std::to_string(ipathId));
+      return;
+    }
+
+    currentPath = ipathId;
+    targetChanged = isRunning.load(std::memory_order_acquire);
+    direction.store(1 - 2 * ibackwards, std::memory_order_release);
+    mirrored.store(imirrored, std::memory_order_release);
+    isRunning.store(true, std::memory_order_release);
+  }
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in
+   * another thread by the controller. This just calls setTarget().
+   */
+  void controllerSet(PathStore::Handle ivalue) override {
+    setTarget(ivalue);
+  }
+
+  /**
+   * @return The last target that was set.
+   */
+  PathStore::Handle getTarget() override {
+    return currentPath;
+  }
+
+  /**
+   * @return The last target that was set.
+   */
+  PathStore::Handle getProcessValue() const override {
+    return currentPath;
+  }
+
+  /**
+   * Blocks the current task until the controller has settled. This controller is settled when
+   * it has finished following a path. If no path is being followed, it is settled.
+   */
+  void waitUntilSettled() override {
+    LOG_INFO_S("AsyncFlatMotionProfileController: Waiting to settle");
+
+    auto rate = timeUtil.getRate();
+    while (!isSettled()) {
+      rate->delayUntil(10_ms);
+    }
+
+    LOG_INFO_S("AsyncFlatMotionProfileController: Done waiting to settle");
+  }
+
+  /**
+   * Returns 0 with no units. This controller has no meaningful error.
+   */
+  PathfinderPoint getError() const override {
+    return PathfinderPoint{0_m, 0_m, 0_deg};
+  }
+
+  /**
+   * @return Whether the controller is disabled or has finished following its path.
+   */
+  bool isSettled() override {
+    return isDisabled() || !isRunning.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Stops the path being followed and leaves the controller enabled.
+   */
+  void reset() override {
+    LOG_INFO_S("AsyncFlatMotionProfileController: Reset");
+    const bool wasDisabled = isDisabled();
+    flipDisable(true);
+    waitUntilSettled();
+    isRunning.store(false, std::memory_order_release);
+    flipDisable(wasDisabled);
+  }
+
+  /**
+   * Changes whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target.
+   */
+  void flipDisable() override {
+    flipDisable(!disabled.load(std::memory_order_acquire));
+  }
+
+  /**
+   * Sets whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled whether the controller is disabled
+   */
+  void flipDisable(bool iisDisabled) override {
+    LOG_INFO("AsyncFlatMotionProfileController: flipDisable " + std::to_string(iisDisabled));
+    disabled.store(iisDisabled, std::memory_order_release);
+    if (iisDisabled) {
+      model->stop();
+    }
+  }
+
+  /**
+   * @return Whether the controller is currently disabled.
+   */
+  bool isDisabled() const override {
+    return disabled.load(std::memory_order_acquire);
+  }
+
+  /**
+   * This is a no-op.
+   */
+  void tarePosition() override {
+  }
+
+  /**
+   * This is a no-op.
+   */
+  void setMaxVelocity(std::int32_t) override {
+  }
+
+  /**
+   * Starts the internal thread. Call this once after making a new instance of this class.
+   */
+  void startThread() {
+    if (!task) {
+      task = new CrossplatformThread(trampoline, this, "AsyncFlatMotionProfileController");
+    }
+  }
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const {
+    return task;
+  }
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  PathfinderLimits limits;
+  std::shared_ptr<ChassisModel> model;
+  ChassisScales scales;
+  AbstractMotor::GearsetRatioPair pair;
+  TimeUtil timeUtil;
+
+  // This must be locked when accessing the store or the current path
+  CrossplatformMutex currentPathMutex;
+  PathStore store;
+  std::shared_ptr<Odometry> odometry;
+  double ramseteB{2.0};
+  double ramseteZeta{0.7};
+
+  PathStore::Handle currentPath{PathStore::invalidHandle};
+  // The path the running one was started from, runningPath is it or its latest replan
+  PathStore::Handle startedPath{PathStore::invalidHandle};
+  PathStore::Handle runningPath{PathStore::invalidHandle};
+  bool targetChanged{false};
+
+  // The replanner and its settings, replan requests and swaps are guarded by currentPathMutex
+  std::shared_ptr<PathReplanner> replanner;
+  double replanError{0};
+  std::size_t replanLookahead{0};
+  CrossplatformThread *replanTask{nullptr};
+  std::atomic_bool replanRequested{false};
+  squiggles::ControlVector replanState;
+  std::size_t replanIndex{0};
+  // After a failed replan, no new one is asked for until this point of the running path
+  std::size_t replanRetryIndex{0};
+  bool replanWarned{false};
+  static constexpr std::size_t replanBackoff = 10;
+  std::size_t swapIndex{0};
+  std::uint32_t swapCount{0};
+  // Counts the paths started, so a replan which finishes after its path ended is dropped
+  std::uint32_t pathCount{0};
+  std::atomic_bool isRunning{false};
+  std::atomic_int direction{1};
+  std::atomic_bool mirrored{false};
+  std::atomic_bool disabled{false};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context) {
+    if (context) {
+      static_cast<AsyncFlatMotionProfileController *>(context)->loop();
+    }
+  }
+
+  void loop() {
+    auto rate = timeUtil.getRate();
+    auto pathRate = timeUtil.getRate();
+
+    while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+      if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
+        executeSinglePath(*pathRate);
+        model->stop();
+
+        // A target set during the run starts next
+        std::scoped_lock lock(currentPathMutex);
+        if (!targetChanged) {
+          isRunning.store(false, std::memory_order_release);
+        }
+      }
+
+      rate->delayUntil(10_ms);
+    }
+  }
+
+  /**
+   * Follows the current path. The handle, direction and mirroring are taken together when the
+   * path starts, so a setTarget() while this runs can't switch paths partway through. The store is
+   * looked up again for every point, so paths can be added or removed, or the path replanned,
+   * while this runs.
+   *
+   * @param irate The rate to step through the path at.
+   */
+  virtual void executeSinglePath(AbstractRate &irate) {
+    const double gearset = toUnderlyingType(pair.internalGearset);
+
+    currentPathMutex.lock();
+    const int reversed = direction.load(std::memory_order_acquire);
+    const bool followMirrored = mirrored.load(std::memory_order_acquire);
+    startedPath = runningPath = currentPath;
+    targetChanged = false;
+    replanRetryIndex = 0;
+    replanWarned = false;
+    pathCount++;
+    replanRequested.store(false, std::memory_order_release);
+    const bool replanning = replanner != nullptr;
+    const double maxError = replanError;
+    std::uint32_t seenSwaps = swapCount;
+    bool closedLoop = store.get(runningPath).follower == PathFollower::ramsete;
+    currentPathMutex.unlock();
+    if (closedLoop && !odometry) {
+      LOG_WARN_S("AsyncFlatMotionProfileController: No odometry was set. Following the path "
+                 "open-loop.");
+      closedLoop = false;
+    }
+    const OdomState start = closedLoop ? odometry->getState() : OdomState{};
+
+    for (std::size_t i = 0; !isDisabled(); i++) {
+      currentPathMutex.lock();
+      if (swapCount != seenSwaps) {
+        // The replanned path starts from the point the replan was asked for
+        seenSwaps = swapCount;
+        i -= std::min(i, swapIndex);
+      }
+      const auto path = store.get(runningPath);
+      if (i >= path.size) {
+        currentPathMutex.unlock();
+        break;
+      }
+      const auto point = path.points[i];
+      // Unlock before the delay to be nice to other tasks
+      currentPathMutex.unlock();
+
+      if (closedLoop) {
+        double leftVel, rightVel;
+        squiggles::ControlVector state;
+        const double error =
+          ramseteStep(point, start, reversed, followMirrored, leftVel, rightVel, state);
+        model->left(store.convertLinearToRotational(leftVel * mps) / gearset);
+        model->right(store.convertLinearToRotational(rightVel * mps) / gearset);
+
+        if (replanning && error > maxError && !replanRequested.load(std::memory_order_acquire)) {
+          std::scoped_lock lock(currentPathMutex);
+          if (i >= replanRetryIndex) {
+            replanState = state;
+            replanIndex = i;
+            replanRequested.store(true, std::memory_order_release);
+          }
+        }
+      } else {
+        const double leftSpeed = point.leftRPM * reversed / gearset;
+        const double rightSpeed = point.rightRPM * reversed / gearset;
+        if (followMirrored) {
+          model->left(rightSpeed);
+          model->right(leftSpeed);
+        } else {
+          model->left(leftSpeed);
+          model->right(rightSpeed);
+        }
+      }
+
+      irate.delayUntil(DT * second);
+    }
+
+    // Replanned paths are only kept while they run
+    std::scoped_lock lock(currentPathMutex);
+    if (runningPath != startedPath) {
+      store.remove(runningPath);
+    }
+    startedPath = runningPath = PathStore::invalidHandle;
+    // A request from the last steps of this path must not replan the next one
+    replanRequested.store(false, std::memory_order_release);
+  }
+
+  /**
+   * Computes the wheel velocities which move the robot towards one point of the path, using the
+   * RAMSETE controller written in the odometry frame (clockwise positive).
+   *
+   * The controller runs in the path's own frame. Driving backwards and mirroring are reflections
+   * of that frame which RAMSETE is symmetric under, so the measured pose is reflected into the
+   * path's frame and the output reflected back.
+   *
+   * @param ipoint The point of the path.
+   * @param istart The odometry state when the path started.
+   * @param ireversed -1 if the path is followed backwards, 1 otherwise.
+   * @param imirrored Whether the path is followed mirrored.
+   * @param oleftVel The left wheel velocity in m/s.
+   * @param orightVel The right wheel velocity in m/s.
+   * @param ostate The measured pose and the commanded velocity, in the path's frame.
+   * @return The distance from the point of the path in meters.
+   */
+  double ramseteStep(const PathStore::Setpoint &ipoint,
+                     const OdomState &istart,
+                     const int ireversed,
+                     const bool imirrored,
+                     double &oleftVel,
+                     double &orightVel,
+                     squiggles::ControlVector &ostate) const {
+    // The measured pose relative to the start of the path
+    const OdomState state = odometry->getState();
+    const double startTheta = istart.theta.convert(radian);
+    const double dx = (state.x - istart.x).convert(meter);
+    const double dy = (state.y - istart.y).convert(meter);
+    double x = dx * std::cos(startTheta) + dy * std::sin(startTheta);
+    double y = -dx * std::sin(startTheta) + dy * std::cos(startTheta);
+    double theta = state.theta.convert(radian) - startTheta;
+
+    // Driving backwards negates the wheel velocities and mirroring swaps them
+    x *= ireversed;
+    theta *= ireversed;
+    if (imirrored) {
+      y = -y;
+      theta = -theta;
+    }
+
+    // The error in the robot's frame
+    const double errorForward =
+      std::cos(theta) * (ipoint.x - x) + std::sin(theta) * (ipoint.y - y);
+    const double errorRight =
+      -std::sin(theta) * (ipoint.x - x) + std::cos(theta) * (ipoint.y - y);
+    const double errorTheta = std::remainder(ipoint.theta - theta, 2 * 1_pi);
+
+    const double refVel = ipoint.linearVel;
+    const double refOmega = ipoint.angularVel;
+    const double k = 2 * ramseteZeta * std::sqrt(refOmega * refOmega + ramseteB * refVel * refVel);
+    const double sinc =
+      std::abs(errorTheta) < 1e-9 ? 1 : std::sin(errorTheta) / errorTheta;
+    const double vel = refVel * std::cos(errorTheta) + k * errorForward;
+    double omega = refOmega + k * errorTheta + ramseteB * refVel * sinc * errorRight;
+    ostate = squiggles::ControlVector(squiggles::Pose(x, y, theta), vel);
+
+    if (imirrored) {
+      omega = -omega;
+    }
+    const double halfTrack = scales.wheelTrack.convert(meter) / 2;
+    oleftVel = (vel + omega * halfTrack) * ireversed;
+    orightVel = (vel - omega * halfTrack) * ireversed;
+    return std::hypot(errorForward, errorRight);
+  }
+
+  /**
+   * Replans the running path whenever the path task asks for it, and swaps the new path in. A
+   * failed replan isn't retried for the next replanBackoff points, and only warns once per path.
+   * Requests are cleared when a path starts and ends, and a replan which finishes after its path
+   * ended is dropped.
+   */
+  void replanLoop() {
+    auto rate = timeUtil.getRate();
+    std::vector<PathStore::Setpoint> previous;
+    std::vector<PathStore::Setpoint> path;
+
+    while (!dtorCalled.load(std::memory_order_acquire) && !replanTask->notifyTake(0)) {
+      if (replanRequested.load(std::memory_order_acquire)) {
+        currentPathMutex.lock();
+        if (!replanRequested.load(std::memory_order_acquire)) {
+          // The path ended since the request was seen
+          currentPathMutex.unlock();
+          continue;
+        }
+        const auto run = pathCount;
+        const auto handle = runningPath;
+        const auto state = replanState;
+        const auto index = replanIndex;
+        const auto span = store.get(handle);
+        previous.assign(span.points, span.points + span.size);
+        // Held on to, so enableReplanning() can replace it while this replans
+        const auto pathReplanner = replanner;
+        const auto lookahead = replanLookahead;
+        currentPathMutex.unlock();
+
+        const bool replanned =
+          pathReplanner->replan(state,
+                                PathStore::Span{previous.data(), previous.size(), span.follower},
+                                index + lookahead,
+                                path);
+
+        currentPathMutex.lock();
+        bool warn = false;
+        if (pathCount == run && runningPath == handle) {
+          if (replanned) {
+            runningPath = store.add(path, PathFollower::ramsete);
+            if (handle != startedPath) {
+              store.remove(handle);
+            }
+            swapIndex = index;
+            swapCount++;
+            replanRetryIndex = 0;
+          } else {
+            replanRetryIndex = index + replanBackoff;
+            warn = !replanWarned;
+            replanWarned = true;
+          }
+        }
+        if (pathCount == run) {
+          // Otherwise it was cleared when the path ended, and may be the next path's request now
+          replanRequested.store(false, std::memory_order_release);
+        }
+        currentPathMutex.unlock();
+
+        if (warn) {
+          LOG_WARN_S("AsyncFlatMotionProfileController: Replanning failed. Staying on the "
+                     "current path.");
+        }
+      }
+
+      rate->delayUntil(5_ms);
+    }
+  }
+
+  static void replanTrampoline(void *context) {
+    if (context) {
+      static_cast<AsyncFlatMotionProfileController *>(context)->replanLoop();
+    }
+  }
+
+  static constexpr double DT = 0.01;
+};
+} // namespace okapi
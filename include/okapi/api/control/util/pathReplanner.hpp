@@ -0,0 +1,207 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathStore.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * Replans the rest of a stored path from the robot's current state, quickly enough to run while
+ * the path is being followed.
+ *
+ * Only the start of the path is replanned: a single quintic connects the current state to the
+ * previous solution at a rejoin point, and the previous setpoints from there on are copied as
+ * they are, poses included. The connection starts with the current pose and velocity and ends with the previous
+ * solution's pose and velocity at the rejoin point, so the result is continuous with both.
+ *
+ * The connection is sampled at a fixed number of points and timed with one forward and one
+ * backward pass under the physical model's constraints. Only a fixed number of curve shapes are
+ * tried, starting from the one that worked last time, so the work per replan is bounded. The
+ * sampling buffers are reused between calls.
+ *
+ * Everything is in the PathStore reference frame: meters forward and right of the start of the
+ * path, and radians clockwise.
+ */
+class PathReplanner {
+  public:
+  /**
+   * Replans the rest of a stored path from the robot's current state.
+   *
+   * @param imodel The model whose constraints the connection must meet. Its constraints must not
+   * depend on the sign of the curvature.
+   * @param istore The store the paths go in, which converts the connection to setpoints. It must
+   * outlive the replanner.
+   * @param idt The time between setpoints in seconds.
+   * @param isamples The number of points the connection curve is sampled at.
+   */
+  PathReplanner(const std::shared_ptr<squiggles::PhysicalModel> &imodel,
+                const PathStore &istore,
+                const double idt = 0.01,
+                const std::size_t isamples = 100)
+    : model(imodel), store(istore), dt(idt), samples(isamples) {
+    times.resize(samples);
+    for (std::size_t i = 0; i < samples; i++) {
+      times[i] = i / (double)(samples - 1);
+    }
+    dist.resize(samples);
+    vel.resize(samples);
+    maxAccel.resize(samples);
+    minAccel.resize(samples);
+  }
+
+  /**
+   * Builds a path from the current state that rejoins a previous solution.
+   *
+   * @param icurrent The current pose and velocity in m/s.
+   * @param iprevious The setpoints of the previous solution.
+   * @param irejoin The index of the setpoint to rejoin the previous solution at.
+   * @param opath The new path, from the current state to the end of the previous solution.
+   * @return Whether a connection that meets the constraints was found.
+   */
+  bool replan(const squiggles::ControlVector &icurrent,
+              const PathStore::Span &iprevious,
+              const std::size_t irejoin,
+              std::vector<PathStore::Setpoint> &opath) {
+    opath.clear();
+    if (irejoin >= iprevious.size) {
+      return false;
+    }
+
+    const auto &goal = iprevious.points[irejoin];
+
+    // Try the shape that worked last time first, then longer and shorter tangents
+    const std::array<double, 4> scales{1.0, 1.4, 0.7, 2.0};
+    for (std::size_t attempt = 0; attempt < scales.size(); attempt++) {
+      const double scale = attempt == 0 ? lastScale : lastScale * scales[attempt];
+      if (connect(icurrent, goal, scale, opath)) {
+        lastScale = scale;
+        opath.insert(opath.end(), iprevious.points + irejoin, iprevious.points + iprevious.size);
+        return true;
+      }
+    }
+
+    opath.clear();
+    return false;
+  }
+
+  protected:
+  std::shared_ptr<squiggles::PhysicalModel> model;
+  const PathStore &store;
+  double dt;
+  std::size_t samples;
+  double lastScale{1.0};
+
+  std::vector<double> times;
+  squiggles::PlanarSamples curve;
+  std::vector<double> dist, vel, maxAccel, minAccel;
+
+  /**
+   * How far short of the rejoin velocity the connection may end, in m/s.
+   */
+  static constexpr double velTolerance = 0.05;
+
+  /**
+   * Finds and times one connection curve.
+   *
+   * @return Whether the curve meets the constraints.
+   */
+  bool connect(const squiggles::ControlVector &icurrent,
+               const PathStore::Setpoint &igoal,
+               const double iscale,
+               std::vector<PathStore::Setpoint> &opath) {
+    const double length =
+      std::hypot(igoal.x - icurrent.pose.x, igoal.y - icurrent.pose.y) * iscale;
+    if (length <= 0) {
+      return false;
+    }
+
+    // The curve is only a shape; timing comes from the passes below. With t from 0 to 1, the
+    // tangents are about as long as the chord so the curve bends evenly.
+    const double startCos = std::cos(icurrent.pose.yaw), startSin = std::sin(icurrent.pose.yaw);
+    const double goalCos = std::cos(igoal.theta), goalSin = std::sin(igoal.theta);
+    const squiggles::QuinticPolynomial xPoly(
+      icurrent.pose.x, length * startCos, 0, igoal.x, length * goalCos, 0, 1);
+    const squiggles::QuinticPolynomial yPoly(
+      icurrent.pose.y, length * startSin, 0, igoal.y, length * goalSin, 0, 1);
+    squiggles::QuinticPolynomial::sample_planar(xPoly, yPoly, times, curve);
+
+    dist[0] = 0;
+    for (std::size_t i = 1; i < samples; i++) {
+      dist[i] = dist[i - 1] + std::hypot(curve.x[i] - curve.x[i - 1], curve.y[i] - curve.y[i - 1]);
+    }
+
+    // Forward pass from the current velocity
+    vel[0] = std::abs(icurrent.vel);
+    for (std::size_t i = 0; i < samples; i++) {
+      const squiggles::Pose pose(curve.x[i], curve.y[i], curve.yaw[i]);
+      if (!std::isfinite(curve.curvature[i])) {
+        return false;
+      }
+      const auto limits = model->constraints(pose, curve.curvature[i], vel[i]);
+      if (std::abs(curve.curvature[i]) > limits.max_curvature) {
+        return false;
+      }
+      maxAccel[i] = limits.max_accel;
+      minAccel[i] = limits.min_accel;
+      vel[i] = std::min(vel[i], limits.max_vel);
+      if (i + 1 < samples) {
+        const double ds = dist[i + 1] - dist[i];
+        vel[i + 1] = std::sqrt(std::max(0.0, vel[i] * vel[i] + 2 * maxAccel[i] * ds));
+      }
+    }
+    if (vel[samples - 1] < igoal.linearVel - velTolerance) {
+      return false;
+    }
+
+    // Backward pass to the rejoin velocity
+    vel[samples - 1] = std::min(vel[samples - 1], igoal.linearVel);
+    for (std::size_t i = samples - 1; i > 0; i--) {
+      const double ds = dist[i] - dist[i - 1];
+      vel[i - 1] =
+        std::min(vel[i - 1], std::sqrt(std::max(0.0, vel[i] * vel[i] - 2 * minAccel[i] * ds)));
+    }
+    if (vel[0] < std::abs(icurrent.vel) - velTolerance) {
+      return false;
+    }
+
+    // Resample at the setpoint period
+    double time = 0;
+    std::size_t segment = 0;
+    double segmentStart = 0;
+    while (segment + 1 < samples) {
+      const double ds = dist[segment + 1] - dist[segment];
+      const double meanVel = std::max((vel[segment] + vel[segment + 1]) / 2, 1e-3);
+      const double segmentTime = ds / meanVel;
+      if (time > segmentStart + segmentTime) {
+        segmentStart += segmentTime;
+        segment++;
+        continue;
+      }
+
+      const double u = segmentTime > 0 ? (time - segmentStart) / segmentTime : 0;
+      const double v = vel[segment] + (vel[segment + 1] - vel[segment]) * u;
+      const double curvature =
+        curve.curvature[segment] + (curve.curvature[segment + 1] - curve.curvature[segment]) * u;
+      opath.push_back(
+        store.makeSetpoint(curve.x[segment] + (curve.x[segment + 1] - curve.x[segment]) * u,
+                           curve.y[segment] + (curve.y[segment + 1] - curve.y[segment]) * u,
+                           curve.yaw[segment],
+                           v,
+                           v * curvature));
+      time += dt;
+    }
+
+    return true;
+  }
+};
+} // namespace okapi
@@ -0,0 +1,283 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * How a stored path is followed.
+ */
+enum class PathFollower {
+  openLoop, ///< Replay the wheel velocities through the motors' velocity control
+  ramsete   ///< Correct towards the path's reference poses using odometry
+};
+
+/**
+ * Stores generated two wheel paths as motor velocity setpoints, all in one contiguous arena.
+ *
+ * Adding a path converts its wheel velocities to motor rpm once, so nothing needs converting
+ * while the path runs. Each path is named by an integer handle which indexes straight into a
+ * table of arena spans, so looking a path up is O(1) and never allocates.
+ *
+ * Every setpoint also carries the pose and velocities the robot should have at that step, for
+ * closed-loop followers. They are found by integrating the wheel velocities, so they describe
+ * exactly the motion that replaying the path open-loop would give, in the odometry
+ * FRAME_TRANSFORMATION frame relative to the pose the path starts from.
+ *
+ * Handles are never reused. Removing a path only marks its points as garbage; the arena is
+ * compacted once the garbage outgrows the live points, which moves points but keeps every handle
+ * valid. Points returned by get() are only valid until the next add(), remove(), or clear().
+ */
+class PathStore {
+  public:
+  using Handle = std::uint32_t;
+
+  /**
+   * A handle that never names a path.
+   */
+  static constexpr Handle invalidHandle = std::numeric_limits<Handle>::max();
+
+  /**
+   * The motor velocities and reference state for one step of a path.
+   */
+  struct Setpoint {
+    double leftRPM;
+    double rightRPM;
+    double x;          // Meters forward of the start
+    double y;          // Meters right of the start
+    double theta;      // Radians clockwise from the start
+    double linearVel;  // m/s
+    double angularVel; // rad/s, clockwise
+  };
+
+  /**
+   * The setpoints of one path.
+   */
+  struct Span {
+    const Setpoint *points;
+    std::size_t size;
+    PathFollower follower;
+  };
+
+  /**
+   * Stores generated two wheel paths as motor velocity setpoints.
+   *
+   * @param iscales The chassis dimensions, used to convert wheel velocities to motor rpm.
+   * @param ipair The gearset and external ratio of the drive motors.
+   */
+  PathStore(const ChassisScales &iscales, const AbstractMotor::GearsetRatioPair &ipair)
+    : scales(iscales), pair(ipair) {
+  }
+
+  /**
+   * Reserves space so adding paths up to these totals does not allocate.
+   *
+   * @param ipaths The total number of paths.
+   * @param ipoints The total number of points across all paths.
+   */
+  void reserve(const std::size_t ipaths, const std::size_t ipoints) {
+    spans.reserve(ipaths);
+    arena.reserve(ipoints);
+  }
+
+  /**
+   * Converts a generated path to setpoints and stores it.
+   *
+   * @param ipath The path, with left and right wheel velocities in m/s.
+   * @param idt The time between points in seconds.
+   * @param ifollower How the path should be followed.
+   * @return The handle for the path.
+   */
+  Handle add(const std::vector<squiggles::ProfilePoint> &ipath,
+             const double idt,
+             const PathFollower ifollower = PathFollower::openLoop) {
+    const std::size_t offset = arena.size();
+    const double track = scales.wheelTrack.convert(meter);
+    double x = 0, y = 0, theta = 0;
+    for (const auto &point : ipath) {
+      const double left = point.wheel_velocities[0];
+      const double right = point.wheel_velocities[1];
+      const double linearVel = (left + right) / 2;
+      const double angularVel = (left - right) / track;
+      arena.push_back(Setpoint{convertLinearToRotational(left * mps),
+                               convertLinearToRotational(right * mps),
+                               x,
+                               y,
+                               theta,
+                               linearVel,
+                               angularVel});
+
+      // Move to the next point along the heading halfway through the step
+      const double midTheta = theta + angularVel * idt / 2;
+      x += linearVel * std::cos(midTheta) * idt;
+      y += linearVel * std::sin(midTheta) * idt;
+      theta += angularVel * idt;
+    }
+
+    spans.push_back(Entry{offset, ipath.size(), true, ifollower});
+    livePoints += ipath.size();
+    return static_cast<Handle>(spans.size() - 1);
+  }
+
+  /**
+   * Stores setpoints as they are, like a replanned path which reuses part of another one.
+   *
+   * @param isetpoints The setpoints, see makeSetpoint.
+   * @param ifollower How the path should be followed.
+   * @return The handle for the path.
+   */
+  Handle add(const std::vector<Setpoint> &isetpoints, const PathFollower ifollower) {
+    const std::size_t offset = arena.size();
+    arena.insert(arena.end(), isetpoints.begin(), isetpoints.end());
+    spans.push_back(Entry{offset, isetpoints.size(), true, ifollower});
+    livePoints += isetpoints.size();
+    return static_cast<Handle>(spans.size() - 1);
+  }
+
+  /**
+   * Builds a setpoint from a pose and the chassis velocities. Only reads the chassis dimensions,
+   * so it is safe to call while another thread changes the store.
+   *
+   * @param ix Meters forward of the start.
+   * @param iy Meters right of the start.
+   * @param itheta Radians clockwise from the start.
+   * @param ilinearVel The linear velocity in m/s.
+   * @param iangularVel The angular velocity in rad/s, clockwise.
+   * @return The setpoint.
+   */
+  Setpoint makeSetpoint(const double ix,
+                        const double iy,
+                        const double itheta,
+                        const double ilinearVel,
+                        const double iangularVel) const {
+    const double halfTrack = scales.wheelTrack.convert(meter) / 2;
+    return Setpoint{convertLinearToRotational((ilinearVel + iangularVel * halfTrack) * mps),
+                    convertLinearToRotational((ilinearVel - iangularVel * halfTrack) * mps),
+                    ix,
+                    iy,
+                    itheta,
+                    ilinearVel,
+                    iangularVel};
+  }
+
+  /**
+   * Removes a path. Its handle will not name a path again.
+   *
+   * @param ihandle The path to remove.
+   * @return Whether the path was removed.
+   */
+  bool remove(const Handle ihandle) {
+    if (!contains(ihandle)) {
+      return false;
+    }
+
+    spans[ihandle].live = false;
+    livePoints -= spans[ihandle].size;
+    if (arena.size() - livePoints > livePoints) {
+      compact();
+    }
+    return true;
+  }
+
+  /**
+   * Removes every path.
+   */
+  void clear() {
+    for (auto &entry : spans) {
+      entry.live = false;
+    }
+    arena.clear();
+    livePoints = 0;
+  }
+
+  /**
+   * @param ihandle The path.
+   * @return Whether the handle names a stored path.
+   */
+  bool contains(const Handle ihandle) const {
+    return ihandle < spans.size() && spans[ihandle].live;
+  }
+
+  /**
+   * Returns the setpoints of a path, or an empty span if the handle does not name a path.
+   *
+   * @param ihandle The path.
+   * @return The setpoints of the path.
+   */
+  Span get(const Handle ihandle) const {
+    if (!contains(ihandle)) {
+      return Span{nullptr, 0, PathFollower::openLoop};
+    }
+    const auto &entry = spans[ihandle];
+    return Span{arena.data() + entry.offset, entry.size, entry.follower};
+  }
+
+  /**
+   * @return The handles of every stored path.
+   */
+  std::vector<Handle> getPaths() const {
+    std::vector<Handle> out;
+    for (std::size_t i = 0; i < spans.size(); i++) {
+      if (spans[i].live) {
+        out.push_back(static_cast<Handle>(i));
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Converts a wheel velocity to a motor velocity.
+   *
+   * @param ilinear The wheel velocity.
+   * @return The motor velocity in rpm.
+   */
+  double convertLinearToRotational(const QSpeed ilinear) const {
+    return (ilinear * (360_deg / (scales.wheelDiameter * 1_pi)) * pair.ratio).convert(rpm);
+  }
+
+  protected:
+  struct Entry {
+    std::size_t offset;
+    std::size_t size;
+    bool live;
+    PathFollower follower;
+  };
+
+  ChassisScales scales;
+  AbstractMotor::GearsetRatioPair pair;
+  std::vector<Setpoint> arena;
+  std::vector<Entry> spans;
+  std::size_t livePoints{0};
+
+  /**
+   * Moves the live paths to the front of the arena, in order.
+   */
+  void compact() {
+    std::size_t next = 0;
+    for (auto &entry : spans) {
+      if (entry.live) {
+        std::copy(arena.begin() + entry.offset,
+                  arena.begin() + entry.offset + entry.size,
+                  arena.begin() + next);
+        entry.offset = next;
+        next += entry.size;
+      }
+    }
+    arena.resize(next);
+  }
+};
+} // namespace okapi
@@ -0,0 +1,85 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace okapi {
+/**
+ * Moving averages of many channels at once, eg. the velocities of all six drive motors. Each
+ * channel gives the same output as a RunningAverageFilter<n>.
+ *
+ * Readings are stored tap by tap, with every channel of a tap next to each other, so each step is
+ * a plain loop over contiguous channels that the compiler can vectorize. Like
+ * RunningAverageFilter, the sums are recomputed exactly each time the window wraps around.
+ *
+ * @tparam n number of taps in each filter
+ * @tparam channels number of channels
+ */
+template <std::size_t n, std::size_t channels> class BatchAverageFilter {
+  public:
+  /**
+   * Batched running sum averaging filter.
+   */
+  BatchAverageFilter() = default;
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements, one per channel
+   * @return filtered results, one per channel
+   */
+  const std::array<double, channels> &filter(const std::array<double, channels> &ireadings) {
+    filter(ireadings.data());
+    return output;
+  }
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings pointer to channels new measurements
+   * @return filtered results, one per channel
+   */
+  const std::array<double, channels> &filter(const double *ireadings) {
+    double *oldest = data[index].data();
+    for (std::size_t c = 0; c < channels; c++) {
+      sums[c] += ireadings[c] - oldest[c];
+      oldest[c] = ireadings[c];
+    }
+
+    if (++index >= n) {
+      index = 0;
+      sums.fill(0);
+      for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t c = 0; c < channels; c++) {
+          sums[c] += data[i][c];
+        }
+      }
+    }
+
+    for (std::size_t c = 0; c < channels; c++) {
+      output[c] = sums[c] / (double)n;
+    }
+    return output;
+  }
+
+  /**
+   * Returns the previous outputs from filter.
+   *
+   * @return the previous outputs from filter
+   */
+  const std::array<double, channels> &getOutput() const {
+    return output;
+  }
+
+  protected:
+  std::array<std::array<double, channels>, n> data{};
+  std::array<double, channels> sums{};
+  std::array<double, channels> output{};
+  std::size_t index = 0;
+};
+} // namespace okapi
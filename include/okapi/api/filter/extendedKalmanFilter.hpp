@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/matrix.hpp"
+#include <cstddef>
+
+namespace okapi {
+/**
+ * Multi-state extended Kalman filter. The state size is a template parameter and every matrix is
+ * a fixed size Matrix, so a filter is a plain value: no heap, and the cost of a step is fixed at
+ * compile time.
+ *
+ * The filter does not own a model. Models evaluate their own transition and Jacobian and hand them
+ * to predict(), see DiffDriveProcessModel. Each sensor calls update() with its own measurement
+ * size, so sensors with different sizes and rates can be fused into the same state.
+ *
+ * @tparam n number of states
+ */
+template <std::size_t n> class ExtendedKalmanFilter {
+  public:
+  /**
+   * Extended Kalman filter.
+   *
+   * @param ix initial state
+   * @param iP initial state covariance
+   */
+  explicit ExtendedKalmanFilter(const Vector<n> &ix = Vector<n>(),
+                                const Matrix<n, n> &iP = Matrix<n, n>::identity())
+    : x(ix), P(iP) {
+  }
+
+  /**
+   * Replaces the state and its covariance.
+   *
+   * @param ix new state
+   * @param iP new state covariance
+   */
+  void reset(const Vector<n> &ix, const Matrix<n, n> &iP) {
+    x = ix;
+    P = iP;
+  }
+
+  /**
+   * Moves the state forward with a model that was already evaluated at the current state.
+   *
+   * @param ixNext the model's next state, f(x)
+   * @param iF the Jacobian of f at x
+   * @param iQ process noise covariance for this step
+   */
+  void predict(const Vector<n> &ixNext, const Matrix<n, n> &iF, const Matrix<n, n> &iQ) {
+    x = ixNext;
+    P = iF * P * iF.transpose() + iQ;
+    P.symmetrize();
+  }
+
+  /**
+   * Corrects the state with a measurement, given its innovation (measurement minus predicted
+   * measurement). Passing the innovation lets the caller wrap angles and use a nonlinear
+   * measurement function.
+   *
+   * @param iinnovation z - h(x)
+   * @param iH the Jacobian of h at x
+   * @param iR measurement noise covariance
+   * @param igate rejects the measurement if its squared Mahalanobis distance is above this, 0 to
+   * accept everything. For a 3 degree of freedom measurement, 11.3 rejects 1% of good readings.
+   * @return false if the measurement was rejected or its covariance was singular
+   */
+  template <std::size_t m>
+  bool update(const Vector<m> &iinnovation,
+              const Matrix<m, n> &iH,
+              const Matrix<m, m> &iR,
+              const double igate = 0) {
+    const Matrix<n, m> PHt = P * iH.transpose();
+    const Matrix<m, m> S = iH * PHt + iR;
+    Matrix<m, m> Sinv;
+    if (!S.inverse(Sinv)) {
+      return false;
+    }
+
+    const double distance = (iinnovation.transpose() * Sinv * iinnovation)(0, 0);
+    lastDistance = distance;
+    if (igate > 0 && distance > igate) {
+      return false;
+    }
+
+    const Matrix<n, m> K = PHt * Sinv;
+    x += K * iinnovation;
+
+    // Joseph form keeps P positive definite through rounding
+    const Matrix<n, n> IKH = Matrix<n, n>::identity() - K * iH;
+    P = IKH * P * IKH.transpose() + K * iR * K.transpose();
+    P.symmetrize();
+    return true;
+  }
+
+  /**
+   * Corrects the state with a linear measurement, z = Hx.
+   *
+   * @param iz measurement
+   * @param iH measurement matrix
+   * @param iR measurement noise covariance
+   * @param igate see update(iinnovation, iH, iR, igate)
+   * @return false if the measurement was rejected or its covariance was singular
+   */
+  template <std::size_t m>
+  bool updateLinear(const Vector<m> &iz,
+                    const Matrix<m, n> &iH,
+                    const Matrix<m, m> &iR,
+                    const double igate = 0) {
+    return update<m>(iz - iH * x, iH, iR, igate);
+  }
+
+  /**
+   * @return the state estimate
+   */
+  const Vector<n> &getState() const {
+    return x;
+  }
+
+  /**
+   * @return the state covariance
+   */
+  const Matrix<n, n> &getCovariance() const {
+    return P;
+  }
+
+  /**
+   * @return the squared Mahalanobis distance of the last measurement, gated or not
+   */
+  double getLastDistance() const {
+    return lastDistance;
+  }
+
+  protected:
+  Vector<n> x;
+  Matrix<n, n> P;
+  double lastDistance = 0;
+};
+} // namespace okapi
@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <tuple>
+#include <utility>
+
+namespace okapi {
+/**
+ * A filter that passes the input signal through each of its stages in sequence, like
+ * ComposableFilter, with the stages chosen at compile time.
+ *
+ * The stages are stored by value, so every stage call is a direct call the compiler can inline
+ * instead of a virtual call through a shared_ptr. Header-only stages like MedianFilter or
+ * RunningAverageFilter collapse into one function. The pipeline itself is still a Filter, so it
+ * can be handed to anything that takes one.
+ *
+ * Example: FilterPipeline<MedianFilter<5>, EmaFilter> velFilter(MedianFilter<5>(), EmaFilter(0.2));
+ *
+ * @tparam Filters the stages, in order
+ */
+template <typename... Filters> class FilterPipeline : public Filter {
+  static_assert(sizeof...(Filters) > 0, "FilterPipeline needs at least one stage");
+
+  public:
+  /**
+   * A pipeline of default constructed stages.
+   */
+  FilterPipeline() = default;
+
+  /**
+   * A pipeline of the given stages.
+   *
+   * @param ifilters the stages, in order
+   */
+  explicit FilterPipeline(Filters... ifilters) : stages(std::move(ifilters)...) {
+  }
+
+  /**
+   * Filters a value through every stage.
+   *
+   * @param ireading new measurement
+   * @return the output of the last stage
+   */
+  double filter(const double ireading) override {
+    output = std::apply(
+      [ireading](Filters &... istages) {
+        double value = ireading;
+        ((value = istages.Filters::filter(value)), ...);
+        return value;
+      },
+      stages);
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  /**
+   * @return stage i of the pipeline
+   */
+  template <std::size_t i> auto &getStage() {
+    return std::get<i>(stages);
+  }
+
+  protected:
+  std::tuple<Filters...> stages;
+  double output = 0;
+};
+} // namespace okapi
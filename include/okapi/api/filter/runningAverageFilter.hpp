@@ -0,0 +1,65 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <array>
+#include <cstddef>
+
+namespace okapi {
+/**
+ * A filter which returns the average of a list of values, like AverageFilter, in O(1) per reading.
+ *
+ * A running sum gains the new reading and loses the oldest one. Adding and subtracting doubles
+ * leaves rounding error behind, so the sum is recomputed exactly each time the window wraps
+ * around. That costs one full pass every n readings, which keeps the error from ever building up.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t n> class RunningAverageFilter : public Filter {
+  public:
+  /**
+   * Running sum averaging filter.
+   */
+  RunningAverageFilter() = default;
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    sum += ireading - data[index];
+    data[index++] = ireading;
+    if (index >= n) {
+      index = 0;
+      sum = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        sum += data[i];
+      }
+    }
+
+    output = sum / (double)n;
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  std::array<double, n> data{0};
+  std::size_t index = 0;
+  double sum = 0;
+  double output = 0;
+};
+} // namespace okapi
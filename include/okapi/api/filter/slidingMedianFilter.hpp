@@ -0,0 +1,144 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace okapi {
+/**
+ * A filter which returns the median value of list of values, like MedianFilter, in O(log n) per
+ * reading instead of O(n). Use this for large windows on fast sensors.
+ *
+ * The window is split into two heaps: a max heap of the lower half and a min heap of the upper
+ * half, so the median is always the top of the lower heap. Each heap tracks where every window
+ * slot sits in it, so the oldest reading is replaced in place and sifted, instead of being
+ * searched for and removed. Everything lives in fixed size arrays.
+ *
+ * For even n this returns the lower of the two middle values, the same as MedianFilter.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t n> class SlidingMedianFilter : public Filter {
+  static_assert(n > 0, "SlidingMedianFilter needs at least one tap");
+
+  public:
+  SlidingMedianFilter() {
+    // The window starts full of zeros, which are valid heaps in any order
+    for (std::size_t i = 0; i < lowSize; i++) {
+      low[i] = i;
+      inLow[i] = true;
+      position[i] = i;
+    }
+    for (std::size_t i = 0; i < highSize; i++) {
+      high[i] = lowSize + i;
+      inLow[lowSize + i] = false;
+      position[lowSize + i] = i;
+    }
+  }
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    const std::size_t slot = index++;
+    if (index >= n) {
+      index = 0;
+    }
+
+    data[slot] = ireading;
+    if (inLow[slot]) {
+      fix(low, lowSize, position[slot], true);
+    } else {
+      fix(high, highSize, position[slot], false);
+    }
+
+    // One value changed, so at most one value is on the wrong side
+    if (highSize > 0 && data[low[0]] > data[high[0]]) {
+      std::swap(low[0], high[0]);
+      inLow[low[0]] = true;
+      position[low[0]] = 0;
+      inLow[high[0]] = false;
+      position[high[0]] = 0;
+      siftDown(low, lowSize, 0, true);
+      siftDown(high, highSize, 0, false);
+    }
+
+    output = data[low[0]];
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  static constexpr std::size_t lowSize = (n & 1) ? (n / 2 + 1) : (n / 2);
+  static constexpr std::size_t highSize = n - lowSize;
+
+  std::array<double, n> data{0};
+  std::array<std::size_t, lowSize> low{};   // Max heap of slots
+  std::array<std::size_t, (highSize > 0 ? highSize : 1)> high{};  // Min heap of slots
+  std::array<bool, n> inLow{};
+  std::array<std::size_t, n> position{};  // Index of each slot in its heap
+  std::size_t index = 0;
+  double output = 0;
+
+  /**
+   * @return true if slot a belongs above slot b in the heap
+   */
+  bool above(const std::size_t a, const std::size_t b, const bool isMax) const {
+    return isMax ? data[a] > data[b] : data[a] < data[b];
+  }
+
+  template <typename Heap>
+  void swapEntries(Heap &heap, const std::size_t i, const std::size_t j) {
+    std::swap(heap[i], heap[j]);
+    position[heap[i]] = i;
+    position[heap[j]] = j;
+  }
+
+  template <typename Heap>
+  void siftDown(Heap &heap, const std::size_t size, std::size_t i, const bool isMax) {
+    while (true) {
+      const std::size_t left = 2 * i + 1;
+      const std::size_t right = left + 1;
+      std::size_t best = i;
+      if (left < size && above(heap[left], heap[best], isMax)) {
+        best = left;
+      }
+      if (right < size && above(heap[right], heap[best], isMax)) {
+        best = right;
+      }
+      if (best == i) {
+        return;
+      }
+      swapEntries(heap, i, best);
+      i = best;
+    }
+  }
+
+  template <typename Heap>
+  void fix(Heap &heap, const std::size_t size, std::size_t i, const bool isMax) {
+    // Sift up if the new value beats its parent, otherwise down
+    while (i > 0 && above(heap[i], heap[(i - 1) / 2], isMax)) {
+      swapEntries(heap, i, (i - 1) / 2);
+      i = (i - 1) / 2;
+    }
+    siftDown(heap, size, i, isMax);
+  }
+};
+} // namespace okapi
@@ -0,0 +1,78 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/fixedTwoEncoderOdometry.hpp"
+
+namespace okapi {
+class FixedThreeEncoderOdometry : public FixedTwoEncoderOdometry {
+  public:
+  /**
+   * ThreeEncoderOdometry that never allocates after construction. See FixedTwoEncoderOdometry.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model the encoders belong to.
+   * @param ileftEnc The left side encoder.
+   * @param irightEnc The right side encoder.
+   * @param imiddleEnc The middle encoder.
+   * @param ichassisScales See ChassisScales docs (the middle wheel scale is the third member)
+   * @param ilogger The logger this instance will log to.
+   */
+  FixedThreeEncoderOdometry(const TimeUtil &itimeUtil,
+                            const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                            const std::shared_ptr<ContinuousRotarySensor> &ileftEnc,
+                            const std::shared_ptr<ContinuousRotarySensor> &irightEnc,
+                            const std::shared_ptr<ContinuousRotarySensor> &imiddleEnc,
+                            const ChassisScales &ichassisScales,
+                            const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger())
+    : FixedTwoEncoderOdometry(itimeUtil, imodel, ileftEnc, irightEnc, ichassisScales, ilogger),
+      middleSensor(imiddleEnc) {
+  }
+
+  protected:
+  std::shared_ptr<ContinuousRotarySensor> middleSensor;
+
+  void readTicks(std::array<std::int32_t, 3> &oticks) override {
+    FixedTwoEncoderOdometry::readTicks(oticks);
+    oticks[2] = static_cast<std::int32_t>(middleSensor->get());
+  }
+
+  /**
+   * Does the math, side-effect free, for one odom step.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const std::array<std::int32_t, 3> &itickDiff,
+                         const QTime &) override {
+    if (tickDiffTooLarge(itickDiff)) {
+      LOG_WARN_S("FixedThreeEncoderOdometry: A tick diff was too large. Skipping this step.");
+      return OdomState{};
+    }
+
+    const double wheelTrack = chassisScales.wheelTrack.convert(meter);
+    const double middleDistance = chassisScales.middleWheelDistance.convert(meter);
+    const double deltaL = itickDiff[0] / chassisScales.straight;
+    const double deltaR = itickDiff[1] / chassisScales.straight;
+    const double deltaTheta = (deltaL - deltaR) / wheelTrack;
+
+    // Remove the part of the middle wheel's travel that came from turning
+    const double deltaM = itickDiff[2] / chassisScales.middle - deltaTheta * middleDistance;
+
+    double localOffX, localOffY;
+    if (deltaTheta != 0) {
+      localOffX = 2 * std::sin(deltaTheta / 2) * (deltaM / deltaTheta + middleDistance);
+      localOffY = 2 * std::sin(deltaTheta / 2) * (deltaR / deltaTheta + wheelTrack / 2);
+    } else {
+      localOffX = deltaM;
+      localOffY = deltaR;
+    }
+
+    return globalStep(localOffX, localOffY, deltaTheta);
+  }
+};
+} // namespace okapi
@@ -0,0 +1,213 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace okapi {
+class FixedTwoEncoderOdometry : public Odometry {
+  public:
+  /**
+   * TwoEncoderOdometry that never allocates after construction. The math is the same, but the
+   * ticks are kept in fixed size arrays and the encoders are read directly, instead of through
+   * ReadOnlyChassisModel::getSensorVals(), which builds a new valarray every step.
+   *
+   * Pass the same encoders the chassis model was built with. The model is only kept for
+   * getModel().
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model the encoders belong to.
+   * @param ileftEnc The left side encoder.
+   * @param irightEnc The right side encoder.
+   * @param ichassisScales The chassis dimensions.
+   * @param ilogger The logger this instance will log to.
+   */
+  FixedTwoEncoderOdometry(const TimeUtil &itimeUtil,
+                          const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                          const std::shared_ptr<ContinuousRotarySensor> &ileftEnc,
+                          const std::shared_ptr<ContinuousRotarySensor> &irightEnc,
+                          const ChassisScales &ichassisScales,
+                          const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger())
+    : logger(ilogger),
+      timer(itimeUtil.getTimer()),
+      model(imodel),
+      leftSensor(ileftEnc),
+      rightSensor(irightEnc),
+      chassisScales(ichassisScales) {
+  }
+
+  virtual ~FixedTwoEncoderOdometry() = default;
+
+  /**
+   * Sets the drive and turn scales.
+   */
+  void setScales(const ChassisScales &ichassisScales) override {
+    chassisScales = ichassisScales;
+  }
+
+  /**
+   * Do one odometry step.
+   */
+  void step() override {
+    const auto deltaT = timer->getDt();
+    if (deltaT.getValue() != 0) {
+      readTicks(newTicks);
+      for (std::size_t i = 0; i < newTicks.size(); i++) {
+        tickDiff[i] = newTicks[i] - lastTicks[i];
+      }
+      lastTicks = newTicks;
+
+      const auto newState = odomMathStep(tickDiff, deltaT);
+      state.x += newState.x;
+      state.y += newState.y;
+      state.theta += newState.theta;
+    }
+  }
+
+  /**
+   * Returns the current state.
+   *
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override {
+    if (imode == StateMode::FRAME_TRANSFORMATION) {
+      return state;
+    }
+    return OdomState{state.y, state.x, state.theta};
+  }
+
+  /**
+   * Sets a new state to be the current state.
+   *
+   * @param istate The new state in the given format.
+   * @param imode The mode to treat the input state as.
+   */
+  void setState(const OdomState &istate,
+                const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override {
+    if (imode == StateMode::FRAME_TRANSFORMATION) {
+      state = istate;
+    } else {
+      state = OdomState{istate.y, istate.x, istate.theta};
+    }
+  }
+
+  /**
+   * @return The internal ChassisModel.
+   */
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override {
+    return model;
+  }
+
+  /**
+   * @return The internal ChassisScales.
+   */
+  ChassisScales getScales() override {
+    return chassisScales;
+  }
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::shared_ptr<ReadOnlyChassisModel> model;
+  std::shared_ptr<ContinuousRotarySensor> leftSensor;
+  std::shared_ptr<ContinuousRotarySensor> rightSensor;
+  ChassisScales chassisScales;
+  OdomState state;
+  std::array<std::int32_t, 3> newTicks{0, 0, 0}, tickDiff{0, 0, 0}, lastTicks{0, 0, 0};
+  const std::int32_t maximumTickDiff{1000};
+
+  /**
+   * Reads the encoders into oticks, in the same order as getSensorVals().
+   *
+   * @param oticks The ticks to write to.
+   */
+  virtual void readTicks(std::array<std::int32_t, 3> &oticks) {
+    oticks[0] = static_cast<std::int32_t>(leftSensor->get());
+    oticks[1] = static_cast<std::int32_t>(rightSensor->get());
+  }
+
+  /**
+   * @return Whether any tick difference is too large to be a real step, eg. after an encoder
+   * reset.
+   */
+  bool tickDiffTooLarge(const std::array<std::int32_t, 3> &itickDiff) const {
+    for (auto diff : itickDiff) {
+      if (std::abs(diff) > maximumTickDiff) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Turns a step in the robot's local frame into a step in the odom frame.
+   *
+   * @param ilocalOffX The sideways offset in meters.
+   * @param ilocalOffY The forward offset in meters.
+   * @param ideltaTheta The change in heading in radians.
+   * @return The newly computed OdomState.
+   */
+  OdomState globalStep(const double ilocalOffX,
+                       const double ilocalOffY,
+                       const double ideltaTheta) const {
+    const double avgA = state.theta.convert(radian) + (ideltaTheta / 2);
+
+    const double polarR = std::sqrt((ilocalOffX * ilocalOffX) + (ilocalOffY * ilocalOffY));
+    const double polarA = std::atan2(ilocalOffY, ilocalOffX) - avgA;
+
+    double dX = std::sin(polarA) * polarR;
+    double dY = std::cos(polarA) * polarR;
+
+    if (std::isnan(dX)) {
+      dX = 0;
+    }
+
+    if (std::isnan(dY)) {
+      dY = 0;
+    }
+
+    return OdomState{dX * meter, dY * meter, ideltaTheta * radian};
+  }
+
+  /**
+   * Does the math, side-effect free, for one odom step.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  virtual OdomState odomMathStep(const std::array<std::int32_t, 3> &itickDiff,
+                                 const QTime &) {
+    if (tickDiffTooLarge(itickDiff)) {
+      LOG_WARN_S("FixedTwoEncoderOdometry: A tick diff was too large. Skipping this step.");
+      return OdomState{};
+    }
+
+    const double wheelTrack = chassisScales.wheelTrack.convert(meter);
+    const double deltaL = itickDiff[0] / chassisScales.straight;
+    const double deltaR = itickDiff[1] / chassisScales.straight;
+    const double deltaTheta = (deltaL - deltaR) / wheelTrack;
+
+    double localOffY;
+    if (deltaTheta != 0) {
+      localOffY = 2 * std::sin(deltaTheta / 2) * (deltaR / deltaTheta + wheelTrack / 2);
+    } else {
+      localOffY = deltaR;
+    }
+
+    return globalStep(0, localOffY, deltaTheta);
+  }
+};
+} // namespace okapi
@@ -0,0 +1,145 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/fixedThreeEncoderOdometry.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include <algorithm>
+
+namespace okapi {
+class ImuThreeEncoderOdometry : public FixedThreeEncoderOdometry {
+  public:
+  /**
+   * Three encoder odometry that takes its heading from an inertial sensor instead of the
+   * difference between the left and right encoders, which drifts whenever the wheels scrub. The
+   * left and right encoders still give forward travel and the middle encoder still gives sideways
+   * slip.
+   *
+   * With a nonzero iencoderBlendRate, the heading is a complementary blend: the inertial sensor is
+   * trusted fully when turning at or above that rate, and the encoders are mixed in linearly as
+   * the rotation rate drops to zero, where gyro drift matters most. With 0 (the default) the
+   * heading is purely from the inertial sensor. Steps where the sensor reads an error or jumps (eg.
+   * after it is reset) fall back to the encoder heading.
+   *
+   * Pass it to ChassisControllerBuilder::withOdometry to use it with DefaultOdomChassisController:
+   *
+   * auto odom = std::make_shared<ImuThreeEncoderOdometry>(
+   *   TimeUtilFactory::createDefault(), model, leftEnc, rightEnc, middleEnc,
+   *   std::make_shared<IMU>(5), scales);
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model the encoders belong to.
+   * @param ileftEnc The left side encoder.
+   * @param irightEnc The right side encoder.
+   * @param imiddleEnc The middle encoder.
+   * @param iimu The heading sensor in degrees, clockwise positive, eg. an IMU on IMUAxes::z.
+   * @param ichassisScales See ChassisScales docs (the middle wheel scale is the third member)
+   * @param iencoderBlendRate The rotation rate at and above which the encoder heading is ignored.
+   * @param ilogger The logger this instance will log to.
+   */
+  ImuThreeEncoderOdometry(const TimeUtil &itimeUtil,
+                          const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                          const std::shared_ptr<ContinuousRotarySensor> &ileftEnc,
+                          const std::shared_ptr<ContinuousRotarySensor> &irightEnc,
+                          const std::shared_ptr<ContinuousRotarySensor> &imiddleEnc,
+                          const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                          const ChassisScales &ichassisScales,
+                          const QAngularSpeed &iencoderBlendRate = 0_rpm,
+                          const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger())
+    : FixedThreeEncoderOdometry(
+        itimeUtil, imodel, ileftEnc, irightEnc, imiddleEnc, ichassisScales, ilogger),
+      imu(iimu),
+      encoderBlendRate(iencoderBlendRate.convert(radps)) {
+  }
+
+  /**
+   * Sets the rotation rate at and above which the encoder heading is ignored. 0 uses only the
+   * inertial sensor.
+   *
+   * @param iencoderBlendRate The new rate.
+   */
+  void setEncoderBlendRate(const QAngularSpeed &iencoderBlendRate) {
+    encoderBlendRate = iencoderBlendRate.convert(radps);
+  }
+
+  protected:
+  std::shared_ptr<ContinuousRotarySensor> imu;
+  double encoderBlendRate;
+  double lastImu{0};
+  double imuDelta{0};
+  bool imuValid{false};
+  bool hasLastImu{false};
+
+  /**
+   * The largest heading change in one step that is believed, in degrees.
+   */
+  static constexpr double maximumImuDiff = 45;
+
+  void readTicks(std::array<std::int32_t, 3> &oticks) override {
+    FixedThreeEncoderOdometry::readTicks(oticks);
+
+    const double reading = imu->get();
+    imuValid = false;
+    if (std::isfinite(reading)) {
+      imuDelta = reading - lastImu;
+      imuValid = hasLastImu && std::abs(imuDelta) <= maximumImuDiff;
+      lastImu = reading;
+      hasLastImu = true;
+    }
+  }
+
+  /**
+   * Does the math for one odom step.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const std::array<std::int32_t, 3> &itickDiff,
+                         const QTime &ideltaT) override {
+    if (tickDiffTooLarge(itickDiff)) {
+      LOG_WARN_S("ImuThreeEncoderOdometry: A tick diff was too large. Skipping this step.");
+      return OdomState{};
+    }
+
+    const double deltaL = itickDiff[0] / chassisScales.straight;
+    const double deltaR = itickDiff[1] / chassisScales.straight;
+    const double encoderTheta = (deltaL - deltaR) / chassisScales.wheelTrack.convert(meter);
+
+    double deltaTheta = encoderTheta;
+    if (imuValid) {
+      const double imuTheta = (imuDelta * degree).convert(radian);
+      double imuWeight = 1;
+      if (encoderBlendRate > 0) {
+        const double rate = std::abs(imuTheta) / ideltaT.convert(second);
+        imuWeight = std::min(1.0, rate / encoderBlendRate);
+      }
+      deltaTheta = imuWeight * imuTheta + (1 - imuWeight) * encoderTheta;
+    } else {
+      LOG_DEBUG_S("ImuThreeEncoderOdometry: No inertial reading. Using the encoder heading.");
+    }
+
+    // Travel of the center of the robot, with the part of the middle wheel's travel that came
+    // from turning removed
+    const double deltaC = (deltaL + deltaR) / 2;
+    const double deltaM = itickDiff[2] / chassisScales.middle -
+                          deltaTheta * chassisScales.middleWheelDistance.convert(meter);
+
+    // The chord of the arc the center traveled along
+    double localOffX, localOffY;
+    if (deltaTheta != 0) {
+      const double chord = 2 * std::sin(deltaTheta / 2) / deltaTheta;
+      localOffX = chord * deltaM;
+      localOffY = chord * deltaC;
+    } else {
+      localOffX = deltaM;
+      localOffY = deltaC;
+    }
+
+    return globalStep(localOffX, localOffY, deltaTheta);
+  }
+};
+} // namespace okapi
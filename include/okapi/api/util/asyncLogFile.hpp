@@ -0,0 +1,156 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace okapi {
+/**
+ * A log file for Logger whose writes never wait on the file. Logger writes each line into a fixed
+ * size buffer and returns, and a background task at the lowest priority writes the buffer out to
+ * the file or serial stream. If the buffer is full, the line is dropped and counted instead of
+ * blocking the caller.
+ *
+ * The buffering is in the file instead of Logger, so it also works for loggers used by the
+ * prebuilt library, like the one ChassisControllerPID logs from its loop through. Make it the
+ * default logger before building any controllers:
+ *
+ * Logger::setDefaultLogger(std::make_shared<Logger>(
+ *   TimeUtilFactory::createDefault().getTimer(), AsyncLogFile::open("/ser/sout"),
+ *   Logger::LogLevel::debug));
+ */
+class AsyncLogFile {
+  public:
+  static constexpr std::size_t bufferSize = 4096;
+
+  /**
+   * Opens a log file. If the file name contains `/ser/`, the file is opened in write mode.
+   * Otherwise, it is opened in append mode, like Logger does.
+   *
+   * @param ifileName The name of the log file to open.
+   * @param iflushPeriod How often the background task writes buffered lines to the file.
+   * @return The file, or nullptr if it could not be opened. Give it to a Logger, which closes it.
+   * Closing it writes out what is still buffered.
+   */
+  static FILE *open(std::string_view ifileName, const QTime &iflushPeriod = 10_ms) {
+    const std::string name(ifileName);
+    FILE *file = fopen(name.c_str(), name.find("/ser/") != std::string::npos ? "w" : "a");
+    if (!file) {
+      return nullptr;
+    }
+
+    auto *buffered = new AsyncLogFile(file, iflushPeriod);
+    FILE *stream = fopencookie(buffered, "w", {nullptr, write, nullptr, close});
+    if (!stream) {
+      close(buffered);
+      return nullptr;
+    }
+    // Unbuffered, so each line goes into the buffer whole before Logger unlocks
+    setvbuf(stream, nullptr, _IONBF, 0);
+    return stream;
+  }
+
+  /**
+   * @return The number of lines dropped because a buffer was full, across every open log file.
+   */
+  static std::uint32_t getDroppedCount() {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+  private:
+  AsyncLogFile(FILE *ifile, const QTime &iflushPeriod)
+    : file(ifile),
+      flushPeriodMs(static_cast<std::uint32_t>(iflushPeriod.convert(millisecond))),
+#ifdef THREADS_STD
+      thread(flushLoop, this)
+#else
+      thread(pros::c::task_create(
+        flushLoop, this, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "OkapiLibAsyncLogFile"))
+#endif
+  {
+  }
+
+  FILE *file;
+  const std::uint32_t flushPeriodMs;
+  // Logger writes under its own lock, so there is one producer, and the flush task is the consumer
+  char buffer[bufferSize];
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+  std::atomic_bool running{true};
+  std::atomic_bool stopped{false};
+  CROSSPLATFORM_THREAD_T thread;
+  static inline std::atomic<std::uint32_t> dropped{0};
+
+  static ssize_t write(void *icookie, const char *idata, std::size_t isize) {
+    auto *self = static_cast<AsyncLogFile *>(icookie);
+    const std::size_t h = self->head.load(std::memory_order_relaxed);
+    if (bufferSize - (h - self->tail.load(std::memory_order_acquire)) < isize) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return static_cast<ssize_t>(isize);
+    }
+
+    for (std::size_t i = 0; i < isize; i++) {
+      self->buffer[(h + i) % bufferSize] = idata[i];
+    }
+    self->head.store(h + isize, std::memory_order_release);
+    return static_cast<ssize_t>(isize);
+  }
+
+  /**
+   * Stops the flush task, writes out the buffer, and closes the file.
+   */
+  static int close(void *icookie) {
+    auto *self = static_cast<AsyncLogFile *>(icookie);
+    self->running.store(false, std::memory_order_release);
+#ifdef THREADS_STD
+    self->thread.join();
+#else
+    while (!self->stopped.load(std::memory_order_acquire)) {
+      pros::c::delay(1);
+    }
+#endif
+
+    const int result = fclose(self->file);
+    delete self;
+    return result;
+  }
+
+  void drain() {
+    std::size_t t = tail.load(std::memory_order_relaxed);
+    const std::size_t h = head.load(std::memory_order_acquire);
+    while (t != h) {
+      // Up to the end of the buffer, then the rest from its start
+      const std::size_t start = t % bufferSize;
+      const std::size_t count = std::min(h - t, bufferSize - start);
+      fwrite(buffer + start, 1, count, file);
+      t += count;
+    }
+    tail.store(t, std::memory_order_release);
+    fflush(file);
+  }
+
+  static void flushLoop(void *iparams) {
+    auto *self = static_cast<AsyncLogFile *>(iparams);
+    while (self->running.load(std::memory_order_acquire)) {
+      self->drain();
+#ifdef THREADS_STD
+      std::this_thread::sleep_for(std::chrono::milliseconds(self->flushPeriodMs));
+#else
+      pros::c::delay(self->flushPeriodMs);
+#endif
+    }
+    self->drain();
+    self->stopped.store(true, std::memory_order_release);
+  }
+};
+} // namespace okapi
@@ -0,0 +1,238 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace okapi {
+/**
+ * A fixed size, row major matrix of doubles. The size is part of the type, so the storage lives
+ * wherever the matrix does (on the stack, in a member) and nothing is ever allocated. Mismatched
+ * sizes fail to compile instead of failing at runtime.
+ *
+ * @tparam rows number of rows
+ * @tparam cols number of columns
+ */
+template <std::size_t rows, std::size_t cols> class Matrix {
+  public:
+  /**
+   * A matrix of zeros.
+   */
+  constexpr Matrix() = default;
+
+  /**
+   * A matrix filled row by row. Missing values are zero.
+   *
+   * @param ivalues values in row major order
+   */
+  Matrix(std::initializer_list<double> ivalues) {
+    std::size_t i = 0;
+    for (double value : ivalues) {
+      if (i >= rows * cols) {
+        break;
+      }
+      data[i++] = value;
+    }
+  }
+
+  /**
+   * @return an identity matrix
+   */
+  static Matrix identity() {
+    static_assert(rows == cols, "Only square matrices have an identity");
+    Matrix out;
+    for (std::size_t i = 0; i < rows; i++) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  /**
+   * @return a square matrix with ivalues on the diagonal
+   */
+  static Matrix diagonal(std::initializer_list<double> ivalues) {
+    static_assert(rows == cols, "Only square matrices have a diagonal");
+    Matrix out;
+    std::size_t i = 0;
+    for (double value : ivalues) {
+      if (i >= rows) {
+        break;
+      }
+      out(i, i) = value;
+      i++;
+    }
+    return out;
+  }
+
+  double &operator()(std::size_t irow, std::size_t icol) {
+    return data[irow * cols + icol];
+  }
+
+  double operator()(std::size_t irow, std::size_t icol) const {
+    return data[irow * cols + icol];
+  }
+
+  /**
+   * Element access for column vectors.
+   */
+  double &operator[](std::size_t i) {
+    static_assert(cols == 1, "Single index access is only for column vectors");
+    return data[i];
+  }
+
+  double operator[](std::size_t i) const {
+    static_assert(cols == 1, "Single index access is only for column vectors");
+    return data[i];
+  }
+
+  Matrix &operator+=(const Matrix &rhs) {
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      data[i] += rhs.data[i];
+    }
+    return *this;
+  }
+
+  Matrix &operator-=(const Matrix &rhs) {
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      data[i] -= rhs.data[i];
+    }
+    return *this;
+  }
+
+  Matrix &operator*=(double iscalar) {
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      data[i] *= iscalar;
+    }
+    return *this;
+  }
+
+  friend Matrix operator+(Matrix lhs, const Matrix &rhs) {
+    return lhs += rhs;
+  }
+
+  friend Matrix operator-(Matrix lhs, const Matrix &rhs) {
+    return lhs -= rhs;
+  }
+
+  friend Matrix operator*(Matrix lhs, double iscalar) {
+    return lhs *= iscalar;
+  }
+
+  friend Matrix operator*(double iscalar, Matrix rhs) {
+    return rhs *= iscalar;
+  }
+
+  /**
+   * @return the transpose of this matrix
+   */
+  Matrix<cols, rows> transpose() const {
+    Matrix<cols, rows> out;
+    for (std::size_t r = 0; r < rows; r++) {
+      for (std::size_t c = 0; c < cols; c++) {
+        out(c, r) = (*this)(r, c);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Averages this matrix with its transpose. Covariances drift away from symmetric through
+   * rounding, this puts them back.
+   */
+  void symmetrize() {
+    static_assert(rows == cols, "Only square matrices can be symmetric");
+    for (std::size_t r = 0; r < rows; r++) {
+      for (std::size_t c = r + 1; c < cols; c++) {
+        const double mean = ((*this)(r, c) + (*this)(c, r)) / 2;
+        (*this)(r, c) = mean;
+        (*this)(c, r) = mean;
+      }
+    }
+  }
+
+  /**
+   * Inverts this matrix with Gauss-Jordan elimination and partial pivoting.
+   *
+   * @param oinverse the inverse, left untouched if this matrix is singular
+   * @return false if this matrix is singular
+   */
+  bool inverse(Matrix &oinverse) const {
+    static_assert(rows == cols, "Only square matrices have an inverse");
+    Matrix a = *this;
+    Matrix inv = identity();
+
+    for (std::size_t c = 0; c < cols; c++) {
+      std::size_t pivot = c;
+      for (std::size_t r = c + 1; r < rows; r++) {
+        if (std::fabs(a(r, c)) > std::fabs(a(pivot, c))) {
+          pivot = r;
+        }
+      }
+
+      if (std::fabs(a(pivot, c)) < 1e-12) {
+        return false;
+      }
+
+      if (pivot != c) {
+        for (std::size_t k = 0; k < cols; k++) {
+          std::swap(a(pivot, k), a(c, k));
+          std::swap(inv(pivot, k), inv(c, k));
+        }
+      }
+
+      const double scale = 1.0 / a(c, c);
+      for (std::size_t k = 0; k < cols; k++) {
+        a(c, k) *= scale;
+        inv(c, k) *= scale;
+      }
+
+      for (std::size_t r = 0; r < rows; r++) {
+        const double factor = a(r, c);
+        if (r == c || factor == 0) {
+          continue;
+        }
+        for (std::size_t k = 0; k < cols; k++) {
+          a(r, k) -= factor * a(c, k);
+          inv(r, k) -= factor * inv(c, k);
+        }
+      }
+    }
+
+    oinverse = inv;
+    return true;
+  }
+
+  std::array<double, rows * cols> data{};
+};
+
+template <std::size_t rows, std::size_t inner, std::size_t cols>
+Matrix<rows, cols> operator*(const Matrix<rows, inner> &lhs, const Matrix<inner, cols> &rhs) {
+  Matrix<rows, cols> out;
+  for (std::size_t r = 0; r < rows; r++) {
+    for (std::size_t k = 0; k < inner; k++) {
+      const double value = lhs(r, k);
+      if (value == 0) {
+        continue;
+      }
+      for (std::size_t c = 0; c < cols; c++) {
+        out(r, c) += value * rhs(k, c);
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * A column vector.
+ *
+ * @tparam n number of elements
+ */
+template <std::size_t n> using Vector = Matrix<n, 1>;
+} // namespace okapi
@@ -7,9 +7,26 @@
 #ifndef _MATH_QUINTIC_POLYNOMIAL_HPP_
 #define _MATH_QUINTIC_POLYNOMIAL_HPP_
 
+#include <cmath>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace squiggles {
+/**
+ * The samples of a 2D curve made of an x and a y polynomial, filled by
+ * QuinticPolynomial::sample_planar. Reusing one instance between calls avoids
+ * reallocating the arrays.
+ */
+struct PlanarSamples {
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> dx;
+  std::vector<double> dy;
+  std::vector<double> yaw;
+  std::vector<double> curvature;
+};
+
 class QuinticPolynomial {
   public:
   /**
@@ -42,6 +59,111 @@ class QuinticPolynomial {
   double calc_second_derivative(double t);
   double calc_third_derivative(double t);
 
+  /**
+   * Calculates the values of the polynomial and its derivatives at many time
+   * stamps at once. Each is one Horner form loop over the array, which the
+   * compiler can vectorize. The output arrays must hold n values.
+   *
+   * @param t The time stamps.
+   * @param n The number of time stamps.
+   * @param out The values at each time stamp.
+   */
+  void calc_points(const double* t, std::size_t n, double* out) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = ((((a5 * t[i] + a4) * t[i] + a3) * t[i] + a2) * t[i] + a1) *
+                 t[i] +
+               a0;
+    }
+  }
+
+  void calc_first_derivatives(const double* t,
+                              std::size_t n,
+                              double* out) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] =
+        (((5 * a5 * t[i] + 4 * a4) * t[i] + 3 * a3) * t[i] + 2 * a2) * t[i] +
+        a1;
+    }
+  }
+
+  void calc_second_derivatives(const double* t,
+                               std::size_t n,
+                               double* out) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = ((20 * a5 * t[i] + 12 * a4) * t[i] + 6 * a3) * t[i] + 2 * a2;
+    }
+  }
+
+  void calc_third_derivatives(const double* t,
+                              std::size_t n,
+                              double* out) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = (60 * a5 * t[i] + 24 * a4) * t[i] + 6 * a3;
+    }
+  }
+
+  /**
+   * Samples the 2D curve made of an x and a y polynomial at many time stamps,
+   * with both polynomials evaluated in the same loop over the shared time
+   * stamps. Fills the position, first derivatives, heading (atan2 of the
+   * first derivatives) and curvature at each time stamp.
+   *
+   * @param ix The x polynomial.
+   * @param iy The y polynomial.
+   * @param it The time stamps.
+   * @param osamples The samples to fill. Its arrays are resized to match it.
+   */
+  static void sample_planar(const QuinticPolynomial& ix,
+                            const QuinticPolynomial& iy,
+                            const std::vector<double>& it,
+                            PlanarSamples& osamples) {
+    const std::size_t n = it.size();
+    osamples.x.resize(n);
+    osamples.y.resize(n);
+    osamples.dx.resize(n);
+    osamples.dy.resize(n);
+    osamples.yaw.resize(n);
+    osamples.curvature.resize(n);
+
+    const double* t = it.data();
+    double* x = osamples.x.data();
+    double* y = osamples.y.data();
+    double* dx = osamples.dx.data();
+    double* dy = osamples.dy.data();
+    double* curvature = osamples.curvature.data();
+    for (std::size_t i = 0; i < n; ++i) {
+      const double ti = t[i];
+      x[i] = ((((ix.a5 * ti + ix.a4) * ti + ix.a3) * ti + ix.a2) * ti + ix.a1) *
+               ti +
+             ix.a0;
+      y[i] = ((((iy.a5 * ti + iy.a4) * ti + iy.a3) * ti + iy.a2) * ti + iy.a1) *
+               ti +
+             iy.a0;
+      const double vx =
+        (((5 * ix.a5 * ti + 4 * ix.a4) * ti + 3 * ix.a3) * ti + 2 * ix.a2) *
+          ti +
+        ix.a1;
+      const double vy =
+        (((5 * iy.a5 * ti + 4 * iy.a4) * ti + 3 * iy.a3) * ti + 2 * iy.a2) *
+          ti +
+        iy.a1;
+      const double ax =
+        ((20 * ix.a5 * ti + 12 * ix.a4) * ti + 6 * ix.a3) * ti + 2 * ix.a2;
+      const double ay =
+        ((20 * iy.a5 * ti + 12 * iy.a4) * ti + 6 * iy.a3) * ti + 2 * iy.a2;
+      const double speed_sq = vx * vx + vy * vy;
+      dx[i] = vx;
+      dy[i] = vy;
+      curvature[i] = (vx * ay - vy * ax) / (speed_sq * std::sqrt(speed_sq));
+    }
+
+    // atan2 is a library call, so it gets its own loop to keep the one above
+    // vectorizable
+    for (std::size_t i = 0; i < n; ++i) {
+      osamples.yaw[i] = std::atan2(dy[i], dx[i]);
+    }
+  }
+
   /**
    * Serializes the Quintic Polynomial data for debugging.
    *
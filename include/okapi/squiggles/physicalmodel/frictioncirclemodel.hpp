@@ -0,0 +1,74 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _PHYSICAL_MODEL_FRICTION_CIRCLE_MODEL_HPP_
+#define _PHYSICAL_MODEL_FRICTION_CIRCLE_MODEL_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "physicalmodel/physicalmodel.hpp"
+
+namespace squiggles {
+class FrictionCircleModel : public PhysicalModel {
+  public:
+  /**
+   * Adds a friction circle to another Physical Model: the centripetal
+   * acceleration v^2 * curvature and the acceleration along the path together
+   * may not exceed the grip of the wheels. Curves are taken only as fast as
+   * their curvature allows, the acceleration left over in a curve goes to
+   * speeding up or slowing down, and straight sections are left to the wrapped
+   * model's limits.
+   *
+   * @param imodel The model whose constraints are narrowed.
+   * @param imax_accel The largest total acceleration the wheels can hold in
+   *                   meters per second per second, eg. the coefficient of
+   *                   friction times 9.81.
+   */
+  FrictionCircleModel(std::shared_ptr<PhysicalModel> imodel, double imax_accel)
+    : model(imodel), max_accel(imax_accel) {}
+
+  Constraints
+  constraints(const Pose pose, double curvature, double vel) override {
+    Constraints limits = model->constraints(pose, curvature, vel);
+
+    double abs_curvature = std::abs(curvature);
+    if (abs_curvature > 0) {
+      limits.max_vel =
+        std::min(limits.max_vel, std::sqrt(max_accel / abs_curvature));
+    }
+
+    double lateral = vel * vel * abs_curvature;
+    double longitudinal =
+      lateral < max_accel
+        ? std::sqrt(max_accel * max_accel - lateral * lateral)
+        : 0;
+
+    return Constraints(limits.max_vel,
+                       std::min(limits.max_accel, longitudinal),
+                       limits.max_jerk,
+                       limits.max_curvature,
+                       std::max(limits.min_accel, -longitudinal));
+  }
+
+  std::vector<double> linear_to_wheel_vels(double lin_vel,
+                                           double curvature) override {
+    return model->linear_to_wheel_vels(lin_vel, curvature);
+  }
+
+  std::string to_string() const override {
+    return "FrictionCircleModel {" + model->to_string() +
+           ", max_accel: " + std::to_string(max_accel) + "}";
+  }
+
+  private:
+  std::shared_ptr<PhysicalModel> model;
+  double max_accel;
+};
+} // namespace squiggles
+
+#endif
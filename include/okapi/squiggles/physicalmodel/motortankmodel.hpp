@@ -0,0 +1,229 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _PHYSICAL_MODEL_MOTOR_TANK_MODEL_HPP_
+#define _PHYSICAL_MODEL_MOTOR_TANK_MODEL_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "physicalmodel/tankmodel.hpp"
+
+namespace squiggles {
+struct MotorConstants {
+  /**
+   * Defines the electrical and mechanical characteristics of one drive motor,
+   * measured at the motor's output shaft.
+   *
+   * @param istall_torque The torque at zero speed and nominal voltage in
+   *                      newton meters.
+   * @param ifree_speed The speed at zero load and nominal voltage in radians
+   *                    per second.
+   * @param istall_current The current at zero speed and nominal voltage in
+   *                       amps.
+   * @param icurrent_limit The current the motor is limited to in amps.
+   * @param inominal_voltage The voltage the other constants were measured at.
+   */
+  MotorConstants(double istall_torque,
+                 double ifree_speed,
+                 double istall_current,
+                 double icurrent_limit,
+                 double inominal_voltage = 12)
+    : stall_torque(istall_torque),
+      free_speed(ifree_speed),
+      stall_current(istall_current),
+      current_limit(icurrent_limit),
+      nominal_voltage(inominal_voltage) {}
+
+  /**
+   * The constants for a V5 Smart Motor with the given cartridge.
+   *
+   * @param icartridge_rpm The free speed of the cartridge, eg. 200.
+   */
+  static MotorConstants v5_smart_motor(double icartridge_rpm) {
+    return MotorConstants(
+      2.1 * 100 / icartridge_rpm, icartridge_rpm * 2 * M_PI / 60, 2.5, 2.5);
+  }
+
+  /**
+   * The largest torque the motor can apply while spinning at the given speed.
+   *
+   * @param ispeed The motor speed in radians per second.
+   * @param ivoltage The voltage available to the motor.
+   */
+  double max_torque(double ispeed, double ivoltage) const {
+    double torque = stall_torque * (ivoltage / nominal_voltage -
+                                    ispeed / free_speed);
+    return std::min(torque, stall_torque * current_limit / stall_current);
+  }
+
+  /**
+   * The most negative torque the motor can apply while spinning at the given
+   * speed.
+   *
+   * @param ispeed The motor speed in radians per second.
+   * @param ivoltage The voltage available to the motor.
+   */
+  double min_torque(double ispeed, double ivoltage) const {
+    return -max_torque(-ispeed, ivoltage);
+  }
+
+  double stall_torque;
+  double free_speed;
+  double stall_current;
+  double current_limit;
+  double nominal_voltage;
+};
+
+class MotorTankModel : public TankModel {
+  public:
+  /**
+   * Defines a model of a tank drive whose limits come from its motors. At each
+   * state the velocity is limited by the motors' free speed at the battery
+   * voltage, and the acceleration by the torque each side can still apply at
+   * its wheel speed, given the robot's mass and moment of inertia. Profiles
+   * generated with this model only ask for what the drive can deliver.
+   *
+   * @param itrack_width The distance between the the wheels on each side of the
+   *                     robot in meters.
+   * @param ilinear_constraints The maximum values for the robot's movement.
+   *                            These still apply on top of the motor limits.
+   * @param imotor The constants of each drive motor.
+   * @param imotors_per_side The number of motors driving each side.
+   * @param iwheel_radius The radius of the drive wheels in meters.
+   * @param igear_ratio The wheel speed divided by the motor speed.
+   * @param imass The mass of the robot in kilograms.
+   * @param imoment_of_inertia The moment of inertia of the robot about its
+   *                           center in kilogram square meters.
+   * @param ibattery_voltage The voltage available to the motors.
+   */
+  MotorTankModel(double itrack_width,
+                 Constraints ilinear_constraints,
+                 MotorConstants imotor,
+                 int imotors_per_side,
+                 double iwheel_radius,
+                 double igear_ratio,
+                 double imass,
+                 double imoment_of_inertia,
+                 double ibattery_voltage = 12)
+    : TankModel(itrack_width, ilinear_constraints),
+      track_width(itrack_width),
+      motor(imotor),
+      motors_per_side(imotors_per_side),
+      wheel_radius(iwheel_radius),
+      gear_ratio(igear_ratio),
+      mass(imass),
+      moment_of_inertia(imoment_of_inertia),
+      battery_voltage(ibattery_voltage) {}
+
+  /**
+   * Sets the voltage available to the motors, eg. the current battery voltage
+   * before generating a path.
+   *
+   * @param ibattery_voltage The voltage available to the motors.
+   */
+  void set_battery_voltage(double ibattery_voltage) {
+    battery_voltage = ibattery_voltage;
+  }
+
+  Constraints
+  constraints(const Pose pose, double curvature, double vel) override {
+    Constraints limits = TankModel::constraints(pose, curvature, vel);
+
+    // How fast each wheel moves per unit of linear velocity
+    auto wheels = linear_to_wheel_vels(1, curvature);
+    double left_scale = wheels[0];
+    double right_scale = wheels[1];
+
+    // No wheel may outrun the motors' free speed
+    double free_wheel_speed = motor.free_speed * battery_voltage /
+                              motor.nominal_voltage * gear_ratio * wheel_radius;
+    double fastest = std::max(std::abs(left_scale), std::abs(right_scale));
+    if (fastest > 0) {
+      limits.max_vel = std::min(limits.max_vel, free_wheel_speed / fastest);
+    }
+
+    // Each side's share of the force needed for one unit of linear
+    // acceleration, from m * a = F_l + F_r and J * alpha = (F_l - F_r) * w / 2
+    double turn_per_accel = (left_scale - right_scale) / track_width;
+    double left_mass = mass / 2 + moment_of_inertia * turn_per_accel / track_width;
+    double right_mass =
+      mass / 2 - moment_of_inertia * turn_per_accel / track_width;
+
+    double max_accel = limits.max_accel;
+    double min_accel = limits.min_accel;
+    side_accel_limits(vel * left_scale, left_mass, min_accel, max_accel);
+    side_accel_limits(vel * right_scale, right_mass, min_accel, max_accel);
+    if (max_accel < min_accel) {
+      // No acceleration suits both sides, eg. entering a tight turn faster
+      // than the outer wheel can go. Take the harder deceleration, so the
+      // robot slows back to states the motors can follow.
+      min_accel = max_accel;
+    }
+
+    return Constraints(limits.max_vel,
+                       max_accel,
+                       limits.max_jerk,
+                       limits.max_curvature,
+                       min_accel);
+  }
+
+  std::string to_string() const override {
+    return "MotorTankModel {" + TankModel::to_string() +
+           ", motors_per_side: " + std::to_string(motors_per_side) +
+           ", wheel_radius: " + std::to_string(wheel_radius) +
+           ", gear_ratio: " + std::to_string(gear_ratio) +
+           ", mass: " + std::to_string(mass) +
+           ", moment_of_inertia: " + std::to_string(moment_of_inertia) +
+           ", battery_voltage: " + std::to_string(battery_voltage) + "}";
+  }
+
+  private:
+  /**
+   * Narrows the robot's acceleration limits to what one side can apply.
+   *
+   * @param iwheel_vel The side's wheel velocity in meters per second.
+   * @param ieffective_mass The side's force per unit of linear acceleration.
+   * @param omin_accel The lower acceleration limit to narrow.
+   * @param omax_accel The upper acceleration limit to narrow.
+   */
+  void side_accel_limits(double iwheel_vel,
+                         double ieffective_mass,
+                         double& omin_accel,
+                         double& omax_accel) const {
+    if (ieffective_mass == 0) {
+      return;
+    }
+
+    double motor_speed = iwheel_vel / (wheel_radius * gear_ratio);
+    double force_per_torque = motors_per_side / (gear_ratio * wheel_radius);
+    double max_force =
+      motor.max_torque(motor_speed, battery_voltage) * force_per_torque;
+    double min_force =
+      motor.min_torque(motor_speed, battery_voltage) * force_per_torque;
+
+    double hi = max_force / ieffective_mass;
+    double lo = min_force / ieffective_mass;
+    if (ieffective_mass < 0) {
+      std::swap(hi, lo);
+    }
+    omax_accel = std::min(omax_accel, hi);
+    omin_accel = std::max(omin_accel, lo);
+  }
+
+  double track_width;
+  MotorConstants motor;
+  int motors_per_side;
+  double wheel_radius;
+  double gear_ratio;
+  double mass;
+  double moment_of_inertia;
+  double battery_voltage;
+};
+} // namespace squiggles
+
+#endif
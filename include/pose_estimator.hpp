@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EZ-Template/drive/drive.hpp"
+#include "api.h"
+#include "okapi/api/filter/diffDriveProcessModel.hpp"
+
+/**
+ * States kept for GPS latency compensation, one per tick.  Must cover the GPS latency.
+ */
+#define POSE_HISTORY_SIZE 32
+
+/**
+ * Absolute field pose from wheel odometry, the IMU and an optional GPS sensor.
+ *
+ * A task runs an okapi::ExtendedKalmanFilter at 100 Hz.  Drive encoder velocities and the IMU
+ * heading correct it every tick, so the pose is smooth and fast.  GPS readings arrive slower and
+ * late, so each one is compared against the estimate from when it was taken and weighted by the
+ * error the GPS reports.  Bad or missing GPS readings are skipped and odometry carries on.
+ *
+ * The field frame is the GPS frame: x and y in inches from the center of the field, heading in
+ * degrees clockwise with 0 facing +y.
+ */
+class PoseEstimator {
+ public:
+  /**
+   * A field pose.
+   */
+  struct pose {
+    double x = 0;        // Inches
+    double y = 0;        // Inches
+    double heading = 0;  // Degrees clockwise, 0 faces +y
+  };
+
+  /**
+   * Known pose components, eg. measured off a wall.  Components without their flag are left to
+   * the filter.
+   */
+  struct pose_fix {
+    bool has_x = false;
+    double x = 0;
+    bool has_y = false;
+    double y = 0;
+    bool has_heading = false;
+    double heading = 0;
+    double position_error = 0.5;  // Standard deviation of x and y, inches
+    double heading_error = 1;     // Standard deviation of heading, degrees
+  };
+
+  /**
+   * Starts estimating from odometry and the IMU only.
+   *
+   * \param drive
+   *        Drive to read encoders and the IMU from.
+   * \param track_width
+   *        Distance between the left and right wheels in inches.
+   */
+  PoseEstimator(Drive &drive, double track_width);
+
+  /**
+   * Starts estimating from odometry, the IMU and a GPS sensor.  Set the GPS offset from the center
+   * of the robot on the sensor itself.
+   *
+   * \param drive
+   *        Drive to read encoders and the IMU from.
+   * \param track_width
+   *        Distance between the left and right wheels in inches.
+   * \param gps
+   *        GPS sensor.
+   * \param gps_latency_ms
+   *        Time between the GPS seeing a position and reporting it.
+   */
+  PoseEstimator(Drive &drive, double track_width, pros::Gps &gps, std::uint32_t gps_latency_ms = 40);
+
+  /**
+   * Sets the pose, eg. at the start of autonomous.  Uncertainty starts at zero.
+   */
+  void set_pose(pose new_pose);
+
+  /**
+   * Resets the drive's gyro and encoders to 0, like chassis.reset_gyro() and
+   * chassis.reset_drive_sensor(), without moving the pose.  Use this instead of those while the
+   * estimator runs.  A reset it doesn't know about is only caught when the sensors jump farther
+   * than the robot can move in a tick.
+   */
+  void reset_sensors();
+
+  /**
+   * Corrects some pose components at once.  Nothing reads the pose between the components, so a
+   * move never starts from a half corrected pose.
+   *
+   * \param fix
+   *        Components to correct and how sure they are.
+   */
+  void correct(const pose_fix &fix);
+
+  /**
+   * Returns the latest pose.
+   */
+  pose get_pose();
+
+  /**
+   * Returns the forward velocity in inches per second.
+   */
+  double get_velocity();
+
+  /**
+   * GPS readings with a reported error above this are skipped.
+   *
+   * \param inches
+   *        Largest GPS error to use, in inches.
+   */
+  void set_gps_max_error(double inches);
+
+  /**
+   * Standard deviation of the GPS heading.
+   *
+   * \param degrees
+   *        Heading standard deviation in degrees.
+   */
+  void set_gps_heading_error(double degrees);
+
+  /**
+   * Returns the number of GPS readings that corrected the pose.
+   */
+  std::uint32_t gps_accepted() const { return accepted; }
+
+  /**
+   * Returns the number of GPS readings skipped for a large error or for disagreeing with the pose.
+   */
+  std::uint32_t gps_rejected() const { return rejected; }
+
+ private:
+  Drive &drive;
+  pros::Gps *gps = nullptr;
+  okapi::DiffDriveProcessModel model;
+  okapi::ExtendedKalmanFilter<5> ekf;
+  pros::Mutex mutex;
+
+  // Filter states of past ticks, for GPS readings that arrive late
+  okapi::Vector<5> history[POSE_HISTORY_SIZE];
+  std::uint32_t history_index = 0;
+  std::uint32_t gps_latency_ticks;
+
+  double gps_max_error = 4;
+  double gps_heading_error = 3;
+  double heading_offset = 0;  // Field heading minus IMU heading, degrees
+  double last_gyro = 0;
+  int last_left = 0;
+  int last_right = 0;
+  double last_gps_x = 0;
+  double last_gps_y = 0;
+  std::uint32_t accepted = 0;
+  std::uint32_t rejected = 0;
+  int gated_in_a_row = 0;
+  pros::Task task;
+
+  void estimate_task();
+  void gps_update();
+};
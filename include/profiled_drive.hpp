@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+
+#include "EZ-Template/drive/drive.hpp"
+#include "api.h"
+#include "motion_profile.hpp"
+
+/**
+ * Drives and turns that follow a motion profile instead of a slew ramp or a raw PID.
+ *
+ * Straight drives use a jerk limited (S-curve) profile.  Every tick the profile's position becomes
+ * the target of the drive's leftPID and rightPID.  Its velocity and acceleration are fed forward,
+ * and headingPID holds the heading like Drive::set_drive_pid() does.  The robot brakes on the
+ * profile instead of on PID alone, so it can drive at full speed and still stop on target.
+ *
+ * Turns use a trapezoidal angular velocity profile tracked by turnPID on the IMU heading, with the
+ * same feedforward.  Turn time comes from the limits, so it is the same every time.
+ *
+ * The drive is put in ez::DISABLE while a profile runs, so ez_auto leaves the motors alone.
+ */
+class ProfiledDrive {
+ public:
+  /**
+   * Constraints for a profile, in inches (degrees for turns) and seconds.
+   */
+  struct constraints {
+    double max_velocity;
+    double max_acceleration;
+    double max_jerk;  // 0 turns the jerk limit off
+  };
+
+  /**
+   * Feedforward constants, in motor power (-127 to 127).
+   */
+  struct feedforward {
+    double kv;  // Power per inch/second (degree/second for turns)
+    double ka;  // Power per inch/second^2 (degree/second^2 for turns)
+    double ks;  // Power to overcome static friction, added in the direction of travel
+  };
+
+  /**
+   * Creates the profile follower and its task.
+   *
+   * \param drive
+   *        Drive to follow profiles with.
+   */
+  explicit ProfiledDrive(Drive &drive);
+
+  /**
+   * Sets the default constraints for set_drive_profile().
+   */
+  void set_constraints(double max_velocity, double max_acceleration, double max_jerk);
+
+  /**
+   * Sets the feedforward constants.
+   *
+   * \param kv
+   *        Motor power per inch/second.  About 127 / free speed of the drive.
+   * \param ka
+   *        Motor power per inch/second^2.
+   * \param ks
+   *        Motor power needed to start moving.
+   */
+  void set_feedforward(double kv, double ka, double ks = 0);
+
+  /**
+   * Sets the default turn constraints for set_turn_profile().
+   *
+   * \param max_velocity
+   *        Degrees per second.
+   * \param max_acceleration
+   *        Degrees per second^2, also used to slow down.
+   */
+  void set_turn_constraints(double max_velocity, double max_acceleration);
+
+  /**
+   * Sets the turn feedforward constants.  Each side gets this power, the left forwards and the
+   * right backwards.
+   *
+   * \param kv
+   *        Motor power per degree/second.
+   * \param ka
+   *        Motor power per degree/second^2.
+   * \param ks
+   *        Motor power needed to start turning.
+   */
+  void set_turn_feedforward(double kv, double ka, double ks = 0);
+
+  /**
+   * Drives straight along an S-curve profile.  Returns right away, use wait_drive() to wait.
+   *
+   * \param target
+   *        Distance to drive in inches, negative drives backwards.
+   * \param toggle_heading
+   *        Toggle for heading correction.
+   */
+  void set_drive_profile(double target, bool toggle_heading = true);
+
+  /**
+   * Drives straight along an S-curve profile with its own constraints.
+   */
+  void set_drive_profile(double target, constraints p_limits, bool toggle_heading = true);
+
+  /**
+   * Turns to an absolute heading along a trapezoidal profile.  Returns right away, use
+   * wait_drive() to wait.
+   *
+   * \param target
+   *        Heading to turn to in degrees, like Drive::set_turn_pid().
+   */
+  void set_turn_profile(double target);
+
+  /**
+   * Turns to an absolute heading along a trapezoidal profile with its own constraints.  The jerk
+   * limit is ignored.
+   */
+  void set_turn_profile(double target, constraints p_limits);
+
+  /**
+   * Locks the code until the profile is done and the PID exit conditions are met.
+   */
+  void wait_drive();
+
+  /**
+   * Returns true while a profile is running.
+   */
+  bool is_running() const { return running.load(); }
+
+  /**
+   * Returns the current setpoint, in inches (degrees for turns) from the start of the profile.
+   */
+  SCurveProfile::state get_setpoint() const { return setpoint; }
+
+ private:
+  enum e_kind { DRIVE_PROFILE = 0,
+                TURN_PROFILE = 1 };
+  Drive &drive;
+  constraints limits = {60, 120, 600};
+  feedforward ff = {127.0 / 60.0, 0, 0};
+  constraints turn_limits = {360, 720, 0};
+  feedforward turn_ff = {127.0 / 600.0, 0, 0};
+  e_kind kind = DRIVE_PROFILE;
+  SCurveProfile profile;
+  SCurveProfile::state setpoint;
+  double l_start = 0;
+  double r_start = 0;
+  double heading_start = 0;
+  bool heading_on = true;
+  std::uint32_t start_time = 0;
+  std::atomic_bool running{false};
+  pros::Mutex mutex;
+  pros::Task task;
+  void profile_task();
+  void drive_step();
+  void turn_step();
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#include "api.h"
+
+/**
+ * Max number of tasks the profiler can track.  Every slot is allocated up front.
+ */
+#define PROFILER_MAX_TASKS 12
+
+/**
+ * Histogram bins per task.  Bin 0 counts loops under 1us, bin i counts loops that took
+ * [2^(i-1), 2^i) us, and the last bin catches everything longer.
+ */
+#define PROFILER_BINS 16
+
+namespace profiler {
+/**
+ * Loop statistics for one task.  Only the owning task writes to this, readers may see a loop that
+ * is half recorded, which is fine for a report.
+ */
+struct task_stats {
+  const char *name = "";
+  std::uint32_t budget_us = 0;
+  std::uint32_t period_ms = 0;
+  std::uint32_t loops = 0;
+  std::uint32_t over_budget = 0;
+  std::uint32_t max_us = 0;
+  std::uint64_t total_us = 0;
+  std::uint32_t max_late_us = 0;  // Worst wake up past the requested period
+  std::uint64_t loop_start = 0;
+  std::uint64_t prev_start = 0;
+  std::uint32_t bins[PROFILER_BINS] = {0};
+};
+
+/**
+ * Registers a task with the profiler.
+ *
+ * \param name
+ *        Name that prints in reports.  Must outlive the profiler (a string literal).
+ * \param budget_us
+ *        Time a single loop is allowed to take before it counts as over budget.
+ * \param period_ms
+ *        Expected time between loops, used to measure how late the task wakes up.  0 disables it.
+ *
+ * \return Slot id to pass to loop_begin()/loop_end(), or -1 if every slot is taken.
+ */
+int add_task(const char *name, std::uint32_t budget_us, std::uint32_t period_ms = 0);
+
+/**
+ * Marks the start of a loop body.
+ *
+ * \param id
+ *        Slot id from add_task().
+ */
+void loop_begin(int id);
+
+/**
+ * Marks the end of a loop body and records how long it took.
+ *
+ * \param id
+ *        Slot id from add_task().
+ */
+void loop_end(int id);
+
+/**
+ * Times a loop body for as long as it is in scope.
+ */
+class ScopedLoop {
+ public:
+  explicit ScopedLoop(int id) : id(id) { loop_begin(id); }
+  ~ScopedLoop() { loop_end(id); }
+
+ private:
+  int id;
+};
+
+/**
+ * Creates a pros::Task that runs loop_body every period_ms and profiles each call.
+ *
+ * \param loop_body
+ *        One iteration of the task.  This must not loop forever itself.
+ * \param name
+ *        Task name, also used in reports.
+ * \param budget_us
+ *        Time one call to loop_body is allowed to take.
+ * \param period_ms
+ *        Time between the start of each loop.
+ * \param prio
+ *        Task priority.
+ */
+pros::Task create_task(void (*loop_body)(), const char *name, std::uint32_t budget_us, std::uint32_t period_ms = 10, std::uint32_t prio = TASK_PRIORITY_DEFAULT);
+
+/**
+ * Returns the number of slots handed out.  A task still inside add_task() has a slot, but
+ * get_stats() returns nullptr for it until its fields are written.
+ */
+int task_count();
+
+/**
+ * Returns stats for a registered task, or nullptr for an invalid id.
+ */
+const task_stats *get_stats(int id);
+
+/**
+ * Clears every histogram.  Registrations are kept.
+ */
+void reset();
+
+/**
+ * Prints a report for every task to the terminal.
+ */
+void print();
+
+/**
+ * Prints a one line summary per task to the brain screen.
+ *
+ * \param line
+ *        Starting line to print on, defaults to 0
+ */
+void print_to_screen(int line = 0);
+
+/**
+ * Starts a low priority task that prints the report to the terminal.
+ *
+ * \param interval_ms
+ *        Time between reports.
+ */
+void start_report_task(std::uint32_t interval_ms = 5000);
+}  // namespace profiler
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EZ-Template/drive/drive.hpp"
+#include "api.h"
+
+/**
+ * Frames the recorder can hold before the SD card writer has to catch up.  Must be a power of two.
+ */
+#define REPLAY_BUFFER_SIZE 64
+
+/**
+ * Bumped whenever replay::frame changes, old recordings are refused.
+ */
+#define REPLAY_VERSION 1
+
+namespace replay {
+/**
+ * Everything a PID holds after it computes.  Doubles are kept as is so replays compare bit for bit.
+ */
+struct pid_sample {
+  double target;
+  double error;
+  double prev_error;
+  double integral;
+  double derivative;
+  double output;
+  PID::Constants constants;
+};
+
+/**
+ * Index of each PID in frame::pids.
+ */
+enum e_pid { LEFT = 0,
+             RIGHT = 1,
+             HEADING = 2,
+             TURN = 3,
+             SWING = 4,
+             PID_COUNT = 5 };
+
+/**
+ * One tick of inputs and outputs of the drive.  This is exactly what lands in the file.
+ */
+struct frame {
+  std::uint64_t time_us;
+  std::int32_t mode;
+  std::int32_t left_sensor;
+  std::int32_t right_sensor;
+  std::int32_t left_velocity;
+  std::int32_t right_velocity;
+  std::int32_t axes[4];  // Controller LEFT_X, LEFT_Y, RIGHT_X, RIGHT_Y
+  double left_mA;
+  double right_mA;
+  double gyro;
+  pid_sample pids[PID_COUNT];
+};
+
+/**
+ * Result of a replay.
+ */
+struct result {
+  bool ok = false;              // False if the file could not be read
+  std::uint32_t frames = 0;     // Frames in the file
+  std::uint32_t steps = 0;      // PID computes that were replayed
+  std::uint32_t mismatches = 0; // Replayed computes that did not match bit for bit
+  std::uint32_t gaps = 0;       // Computes that could not be checked, see verify()
+  std::uint64_t first_mismatch_us = 0;
+  std::uint32_t elapsed_us = 0;  // Time the replay took
+};
+
+/**
+ * Starts recording the drive's inputs and PID states every tick.  Frames go through a lock-free
+ * buffer to a low priority task that appends them to the SD card.  The recorder runs just above
+ * the drive's priority, so the drive task can't run between the PID samples of one frame.  If the
+ * drive task was interrupted partway through a tick, the recorder waits up to 3 ms for it to
+ * finish first.
+ *
+ * Does nothing while recording.  After stop_recorder() it also does nothing until the last
+ * recording's file is closed, which takes up to about 50 ms.
+ *
+ * \param drive
+ *        Drive to record.
+ * \param file_name
+ *        File to write, overwritten.
+ * \param period_ms
+ *        Time between frames, keep this at the drive's own tick.
+ */
+void start_recorder(Drive &drive, const char *file_name = "/usd/replay.bin", std::uint32_t period_ms = ez::util::DELAY_TIME);
+
+/**
+ * Stops recording and closes the file once every frame is written.
+ */
+void stop_recorder();
+
+/**
+ * Returns the number of frames dropped because the SD card writer was behind.
+ */
+std::uint32_t dropped();
+
+/**
+ * Replays a recording through fresh PID objects, as fast as the brain can go.  This only checks
+ * the PID arithmetic: each compute is fed the error that was recorded, not the sensors and targets
+ * the error came from, so a bug in how the drive works out the error won't show up here.
+ *
+ * Every time a PID computed between two frames, a new PID is loaded with the recorded constants
+ * and the state it computed from, then fed the error it saw.  Output, integral and derivative have
+ * to match the recording bit for bit.  The state it computed from is the earlier frame, or zero
+ * right after a new target.  If neither fits, a tick ran between the two frames and the compute is
+ * counted as a gap instead of being checked.
+ *
+ * \param file_name
+ *        Recording to replay.
+ * \param print
+ *        Prints every mismatch and a summary to the terminal.
+ */
+result verify(const char *file_name = "/usd/replay.bin", bool print = true);
+}  // namespace replay
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "EZ-Template/PID.hpp"
+#include "api.h"
+
+/**
+ * Max number of telemetry channels.  Every channel is allocated up front.
+ */
+#define TELEMETRY_MAX_CHANNELS 8
+
+/**
+ * Records each channel can hold before the writer has to catch up.  Must be a power of two.
+ */
+#define TELEMETRY_CHANNEL_SIZE 256
+
+/**
+ * Values in a single record.
+ */
+#define TELEMETRY_VALUES 6
+
+/**
+ * Record tag written once per channel when the writer first sees it, values hold the channel name.
+ */
+#define TELEMETRY_TAG_NAME 0xFFFF
+
+/**
+ * Single producer, single consumer ring buffer.  push() and pop() never block and never take a
+ * lock, so one task can fill it while another drains it.
+ *
+ * \tparam T
+ *         Record type, copied in and out.
+ * \tparam N
+ *         Capacity, must be a power of two.
+ */
+template <typename T, std::size_t N>
+class RingBuffer {
+  static_assert(N != 0 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+ public:
+  /**
+   * Adds an item.  Only the producer task may call this.
+   *
+   * \param item
+   *        Item to copy in.
+   *
+   * \return False if the buffer was full and the item was dropped.
+   */
+  bool push(const T &item) {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == N) {
+      drops.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    data[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes up to max items.  Only the consumer task may call this.
+   *
+   * \param out
+   *        Array to copy items into.
+   * \param max
+   *        Size of out.
+   *
+   * \return Number of items copied.
+   */
+  std::size_t pop(T *out, std::size_t max) {
+    std::size_t t = tail.load(std::memory_order_relaxed);
+    std::size_t available = head.load(std::memory_order_acquire) - t;
+    std::size_t n = available < max ? available : max;
+    for (std::size_t i = 0; i < n; i++) out[i] = data[(t + i) & (N - 1)];
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  /**
+   * Returns the number of items waiting to be popped.
+   */
+  std::size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+  /**
+   * Returns the number of items dropped because the buffer was full.
+   */
+  std::uint32_t dropped() const { return drops.load(std::memory_order_relaxed); }
+
+ private:
+  T data[N];
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+  std::atomic<std::uint32_t> drops{0};
+};
+
+namespace telemetry {
+/**
+ * Fixed size binary record.  This is exactly what lands in the file.
+ */
+struct record {
+  std::uint32_t time_ms;
+  std::uint8_t channel;
+  std::uint8_t count;  // Number of values that are used
+  std::uint16_t tag;
+  float values[TELEMETRY_VALUES];
+};
+
+/**
+ * A channel is owned by one control task.  That task is the only one allowed to log into it.
+ */
+class Channel {
+ public:
+  /**
+   * Logs a record.  Never blocks, the record is dropped if the writer is behind.
+   *
+   * \param tag
+   *        User defined id for what the values are.
+   * \param values
+   *        Values to log, anything past TELEMETRY_VALUES is ignored.
+   *
+   * \return False if the record was dropped.
+   */
+  bool log(std::uint16_t tag, std::initializer_list<float> values);
+
+  /**
+   * Logs target, current, error, output, integral and derivative of a PID.
+   *
+   * \param tag
+   *        User defined id for this PID.
+   * \param pid
+   *        PID to log.
+   */
+  bool log_pid(std::uint16_t tag, const PID &pid);
+
+  const char *name = "";
+  std::uint8_t id = 0;
+  RingBuffer<record, TELEMETRY_CHANNEL_SIZE> buffer;
+};
+
+/**
+ * Claims a channel for a control task.
+ *
+ * \param name
+ *        Name written into the file header.  Must outlive the writer (a string literal).
+ *
+ * \return The channel, or nullptr if every channel is taken.
+ */
+Channel *add_channel(const char *name);
+
+/**
+ * Starts the low priority writer task that drains every channel to the SD card.  Does nothing
+ * without an SD card.  Channels added after this get their name record on the next drain.
+ *
+ * \param file_name
+ *        File to append records to.
+ * \param interval_ms
+ *        Time between drains.
+ */
+void start_writer(const char *file_name = "/usd/telemetry.bin", std::uint32_t interval_ms = 100);
+
+/**
+ * Returns the total number of records dropped across every channel.
+ */
+std::uint32_t dropped();
+}  // namespace telemetry
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Wire format for the binary telemetry stream.  This header has no PROS dependencies so the host
+// decoder can include it as is.
+//
+// Every frame is COBS encoded and sent between 0x00 delimiters.  Decoded, a frame is:
+//   [type] [stream id] [body...] [crc8 of everything before it]
+//
+// Schema frame ('S'):  [field count] [stream name\0] then per field [name\0] [scale, float32 LE]
+// Key frame ('K'):     [sequence] [varint time_ms] then per field [zigzag varint value]
+// Delta frame ('D'):   [sequence] [varint dt_ms] then per field [zigzag varint change]
+//
+// Values are sent as integers, value / scale rounded.  Delta frames only make sense after the key
+// frame before them, so a decoder that misses a frame waits for the next key frame.
+
+namespace telemetry {
+namespace codec {
+const std::uint8_t FRAME_SCHEMA = 'S';
+const std::uint8_t FRAME_KEY = 'K';
+const std::uint8_t FRAME_DELTA = 'D';
+
+/**
+ * Largest worst case COBS output for len input bytes, not counting the delimiter.
+ */
+constexpr std::size_t cobs_max_size(std::size_t len) { return len + len / 254 + 1; }
+
+/**
+ * COBS encodes len bytes.  out must hold cobs_max_size(len) bytes.
+ *
+ * \return Bytes written, not counting the delimiter.
+ */
+inline std::size_t cobs_encode(const std::uint8_t *in, std::size_t len, std::uint8_t *out) {
+  std::size_t write = 1, code_index = 0;
+  std::uint8_t code = 1;
+  for (std::size_t read = 0; read < len; read++) {
+    if (in[read] == 0) {
+      out[code_index] = code;
+      code = 1;
+      code_index = write++;
+    } else {
+      out[write++] = in[read];
+      if (++code == 0xFF) {
+        out[code_index] = code;
+        code = 1;
+        code_index = write++;
+      }
+    }
+  }
+  out[code_index] = code;
+  return write;
+}
+
+/**
+ * Decodes one COBS frame, without its delimiter.  out must hold len bytes.
+ *
+ * \return Bytes written, or 0 if the frame is malformed.
+ */
+inline std::size_t cobs_decode(const std::uint8_t *in, std::size_t len, std::uint8_t *out) {
+  std::size_t read = 0, write = 0;
+  while (read < len) {
+    std::uint8_t code = in[read++];
+    if (code == 0 || read + code - 1 > len) return 0;
+    for (std::uint8_t i = 1; i < code; i++) out[write++] = in[read++];
+    if (code != 0xFF && read != len) out[write++] = 0;
+  }
+  return write;
+}
+
+/**
+ * CRC-8, polynomial 0x07.
+ */
+inline std::uint8_t crc8(const std::uint8_t *data, std::size_t len) {
+  std::uint8_t crc = 0;
+  for (std::size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int j = 0; j < 8; j++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+/**
+ * Writes an unsigned LEB128 varint.
+ *
+ * \return Bytes written, at most 5.
+ */
+inline std::size_t put_varint(std::uint8_t *out, std::uint32_t value) {
+  std::size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  out[n++] = value;
+  return n;
+}
+
+/**
+ * Reads an unsigned LEB128 varint.
+ *
+ * \return Bytes read, or 0 if it runs past end.
+ */
+inline std::size_t get_varint(const std::uint8_t *in, const std::uint8_t *end, std::uint32_t &value) {
+  value = 0;
+  for (std::size_t n = 0; n < 5 && in + n < end; n++) {
+    value |= std::uint32_t(in[n] & 0x7F) << (7 * n);
+    if ((in[n] & 0x80) == 0) return n + 1;
+  }
+  return 0;
+}
+
+inline std::uint32_t zigzag(std::int32_t value) { return (std::uint32_t(value) << 1) ^ std::uint32_t(value >> 31); }
+inline std::int32_t unzigzag(std::uint32_t value) { return std::int32_t(value >> 1) ^ -std::int32_t(value & 1); }
+
+/**
+ * Host side decoder.  Feed it raw bytes from the serial port, it calls back with schemas and
+ * decoded records.  Anything that is not a valid frame (plain printf text, a frame cut in half) is
+ * counted and skipped.
+ */
+class Decoder {
+ public:
+  struct Schema {
+    std::string name;
+    std::vector<std::string> fields;
+    std::vector<float> scales;
+  };
+
+  std::function<void(std::uint8_t stream, const Schema &schema)> on_schema;
+  std::function<void(std::uint8_t stream, std::uint32_t time_ms, const std::vector<double> &values)> on_record;
+
+  std::uint32_t bad_frames = 0;
+  std::uint32_t lost_frames = 0;
+
+  /**
+   * Decodes as many frames as the bytes complete.  Partial frames are kept for the next call.
+   */
+  void feed(const std::uint8_t *data, std::size_t len) {
+    for (std::size_t i = 0; i < len; i++) {
+      if (data[i] != 0) {
+        pending.push_back(data[i]);
+        continue;
+      }
+      if (!pending.empty()) handle(pending);
+      pending.clear();
+    }
+  }
+
+ private:
+  struct Stream {
+    Schema schema;
+    bool has_schema = false;
+    bool synced = false;  // Seen a key frame since the last loss
+    std::uint8_t next_sequence = 0;
+    std::uint32_t time_ms = 0;
+    std::vector<std::int32_t> raw;
+  };
+
+  std::vector<std::uint8_t> pending;
+  std::vector<std::uint8_t> frame;
+  std::map<std::uint8_t, Stream> streams;
+
+  void handle(const std::vector<std::uint8_t> &encoded) {
+    frame.resize(encoded.size());
+    std::size_t len = cobs_decode(encoded.data(), encoded.size(), frame.data());
+    if (len < 3 || crc8(frame.data(), len - 1) != frame[len - 1]) {
+      bad_frames++;
+      return;
+    }
+
+    const std::uint8_t *p = frame.data() + 2;
+    const std::uint8_t *end = frame.data() + len - 1;
+    Stream &stream = streams[frame[1]];
+    bool ok = false;
+    switch (frame[0]) {
+      case FRAME_SCHEMA:
+        ok = read_schema(stream, frame[1], p, end);
+        break;
+      case FRAME_KEY:
+      case FRAME_DELTA:
+        ok = read_values(stream, frame[1], frame[0] == FRAME_KEY, p, end);
+        break;
+    }
+    if (!ok) bad_frames++;
+  }
+
+  bool read_schema(Stream &stream, std::uint8_t id, const std::uint8_t *p, const std::uint8_t *end) {
+    if (p >= end) return false;
+    std::size_t count = *p++;
+    Schema schema;
+    if (!read_string(p, end, schema.name)) return false;
+    for (std::size_t i = 0; i < count; i++) {
+      std::string field;
+      float scale;
+      if (!read_string(p, end, field) || end - p < 4) return false;
+      std::memcpy(&scale, p, 4);
+      p += 4;
+      schema.fields.push_back(field);
+      schema.scales.push_back(scale);
+    }
+
+    bool changed = !stream.has_schema || schema.fields != stream.schema.fields || schema.scales != stream.schema.scales;
+    if (changed) {
+      stream.schema = schema;
+      stream.has_schema = true;
+      stream.synced = false;
+      stream.raw.assign(count, 0);
+      if (on_schema) on_schema(id, stream.schema);
+    }
+    return true;
+  }
+
+  bool read_values(Stream &stream, std::uint8_t id, bool key, const std::uint8_t *p, const std::uint8_t *end) {
+    if (p >= end) return false;
+    std::uint8_t sequence = *p++;
+    if (stream.synced && sequence != stream.next_sequence) {
+      lost_frames += std::uint8_t(sequence - stream.next_sequence);
+      stream.synced = false;
+    }
+    stream.next_sequence = sequence + 1;
+    if (!stream.has_schema || (!key && !stream.synced)) return true;
+
+    std::uint32_t time;
+    std::size_t n = get_varint(p, end, time);
+    if (n == 0) return false;
+    p += n;
+
+    std::vector<std::int32_t> raw(stream.raw.size());
+    for (std::size_t i = 0; i < raw.size(); i++) {
+      std::uint32_t value;
+      n = get_varint(p, end, value);
+      if (n == 0) return false;
+      p += n;
+      raw[i] = key ? unzigzag(value) : stream.raw[i] + unzigzag(value);
+    }
+
+    stream.time_ms = key ? time : stream.time_ms + time;
+    stream.raw = raw;
+    stream.synced = true;
+    if (on_record) {
+      std::vector<double> values(raw.size());
+      for (std::size_t i = 0; i < raw.size(); i++) values[i] = raw[i] * double(stream.schema.scales[i]);
+      on_record(id, stream.time_ms, values);
+    }
+    return true;
+  }
+
+  static bool read_string(const std::uint8_t *&p, const std::uint8_t *end, std::string &out) {
+    const std::uint8_t *start = p;
+    while (p < end && *p != 0) p++;
+    if (p == end) return false;
+    out.assign(reinterpret_cast<const char *>(start), p - start);
+    p++;
+    return true;
+  }
+};
+}  // namespace codec
+}  // namespace telemetry
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "EZ-Template/drive/drive.hpp"
+#include "api.h"
+#include "telemetry.hpp"
+#include "telemetry_codec.hpp"
+
+/**
+ * Max number of fields in one stream.
+ */
+#define TELEMETRY_STREAM_FIELDS 16
+
+/**
+ * Max number of streams.
+ */
+#define TELEMETRY_MAX_STREAMS 8
+
+/**
+ * Frames each stream can hold before the serial writer has to catch up.  Must be a power of two.
+ */
+#define TELEMETRY_STREAM_SIZE 16
+
+/**
+ * A key frame with absolute values is sent every this many frames, the rest are deltas.
+ */
+#define TELEMETRY_KEY_INTERVAL 50
+
+/**
+ * Id of a stream that could not be registered.  send() drops everything on it.
+ */
+#define TELEMETRY_INVALID_STREAM 0xFF
+
+namespace telemetry {
+/**
+ * One column of a stream.
+ */
+struct field {
+  const char *name;
+  float scale;  // Resolution the value is sent at, eg. 0.01 sends 2 decimal places
+};
+
+/**
+ * Largest key or delta frame, COBS encoded with its delimiters.
+ */
+const std::size_t STREAM_FRAME_SIZE = codec::cobs_max_size(4 + 5 + 5 * TELEMETRY_STREAM_FIELDS) + 2;
+
+/**
+ * A binary telemetry stream sent over the serial port, see telemetry_codec.hpp for the format.
+ * A stream is owned by one task, that task is the only one allowed to send() on it.
+ */
+class Stream {
+ public:
+  /**
+   * Creates and registers a stream.  If all TELEMETRY_MAX_STREAMS are taken, it prints an error
+   * and the stream gets TELEMETRY_INVALID_STREAM as its id.
+   *
+   * \param name
+   *        Name sent in the schema.  Must outlive the stream (a string literal).
+   * \param fields
+   *        Columns of the stream, anything past TELEMETRY_STREAM_FIELDS is ignored.
+   */
+  Stream(const char *name, std::initializer_list<field> fields);
+
+  /**
+   * Encodes a record and queues it for the serial writer.  Never blocks, the record is dropped if
+   * the writer is behind.
+   *
+   * \param values
+   *        One value per field, in order.
+   *
+   * \return False if the record was dropped or the stream isn't registered.
+   */
+  bool send(std::initializer_list<double> values);
+
+  /**
+   * Returns the number of records dropped because the writer was behind.
+   */
+  std::uint32_t dropped() const { return frames.dropped(); }
+
+  struct frame {
+    std::uint16_t len;
+    std::uint8_t bytes[STREAM_FRAME_SIZE];
+  };
+
+  const char *name;
+  std::uint8_t id = TELEMETRY_INVALID_STREAM;
+  std::uint8_t count = 0;
+  field fields[TELEMETRY_STREAM_FIELDS];
+  RingBuffer<frame, TELEMETRY_STREAM_SIZE> frames;
+
+ private:
+  std::int32_t last[TELEMETRY_STREAM_FIELDS] = {0};
+  std::uint32_t last_time = 0;
+  std::uint8_t sequence = 0;
+  int since_key = TELEMETRY_KEY_INTERVAL;
+};
+
+/**
+ * Starts the low priority task that writes every stream to the serial port.  This turns off PROS
+ * stream multiplexing on the serial port, so read it with the host decoder instead of the PROS
+ * terminal.  Plain printf output still goes through and is skipped by the decoder.
+ *
+ * \param interval_ms
+ *        Time between writes.
+ */
+void start_serial_writer(std::uint32_t interval_ms = 10);
+
+/**
+ * Starts a task that streams target, error and output of every drive PID plus the IMU heading.
+ *
+ * \param drive
+ *        Drive to stream.
+ * \param period_ms
+ *        Time between records.
+ */
+void start_drive_stream(Drive &drive, std::uint32_t period_ms = ez::util::DELAY_TIME);
+}  // namespace telemetry
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "api.h"
+#include "okapi/api/filter/extendedKalmanFilter.hpp"
+
+/**
+ * Objects read from the vision sensor each frame.
+ */
+#define VISION_MAX_OBJECTS 16
+
+/**
+ * Objects tracked at once.
+ */
+#define VISION_MAX_TRACKS 8
+
+/**
+ * Signatures a tracker can follow.
+ */
+#define VISION_MAX_SIGNATURES 7
+
+/**
+ * A value one task writes and any task reads without locks.  The writer fills the slot readers
+ * aren't pointed at, then points them at it, so a writer interrupted halfway never holds up a
+ * reader.  Each slot also has a sequence number the writer bumps before and after writing.  A
+ * reader that sees it change (or odd) while copying was overtaken by two whole writes and tries
+ * again, which only happens while the writer is making progress.  The writer never waits.
+ */
+template <typename T>
+class Snapshot {
+ public:
+  /**
+   * Publishes a new value.  Only one task may write.
+   */
+  void write(const T &value) {
+    std::uint32_t next = published.load(std::memory_order_relaxed) + 1;
+    slot &s = slots[next % 2];
+    s.sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.data = value;
+    std::atomic_thread_fence(std::memory_order_release);
+    s.sequence.fetch_add(1, std::memory_order_relaxed);
+    published.store(next, std::memory_order_release);
+  }
+
+  /**
+   * Returns the latest value.
+   */
+  T read() const {
+    T out;
+    while (true) {
+      const slot &s = slots[published.load(std::memory_order_acquire) % 2];
+      std::uint32_t before = s.sequence.load(std::memory_order_acquire);
+      out = s.data;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      std::uint32_t after = s.sequence.load(std::memory_order_relaxed);
+      if (before == after && !(before & 1)) return out;
+    }
+  }
+
+ private:
+  struct slot {
+    T data{};
+    std::atomic<std::uint32_t> sequence{0};
+  };
+
+  slot slots[2];
+  std::atomic<std::uint32_t> published{0};
+};
+
+/**
+ * Follows game objects seen by a vision sensor.
+ *
+ * A task reads every object once per frame with one read_by_size() call and keeps the ones with a
+ * tracked signature.  Each object is matched to the track whose predicted position is closest, and
+ * a small Kalman filter per track estimates position and velocity in pixels.  The tracks are
+ * published as a Snapshot, so any task can aim at them without waiting on the sensor.
+ */
+class VisionTracker {
+ public:
+  /**
+   * A tracked object.  Coordinates are pixels from the top left of the image.
+   */
+  struct track {
+    std::uint16_t id;  // Stays the same while the object is tracked
+    std::uint16_t signature;
+    float x;
+    float y;
+    float x_velocity;  // Pixels per second
+    float y_velocity;
+    std::int16_t width;
+    std::int16_t height;
+    std::uint32_t last_seen;  // pros::millis() of the last frame it was seen in
+  };
+
+  /**
+   * Every track at one point in time.
+   */
+  struct tracks {
+    std::uint32_t time = 0;
+    int count = 0;
+    track list[VISION_MAX_TRACKS];
+  };
+
+  /**
+   * Creates a tracker.  Nothing is read until start().
+   *
+   * \param port
+   *        Port of the vision sensor.
+   */
+  explicit VisionTracker(std::uint8_t port);
+
+  /**
+   * Tracks objects with this signature.
+   *
+   * \param signature
+   *        Signature id, 1 to 7.
+   */
+  void add_signature(std::uint32_t signature);
+
+  /**
+   * Starts the tracking task.
+   *
+   * \param period_ms
+   *        Time between frames.  The sensor updates every 20 ms.
+   */
+  void start(std::uint32_t period_ms = 20);
+
+  /**
+   * Returns the latest tracks.  Never blocks.
+   */
+  tracks get_tracks() const { return published.read(); }
+
+  /**
+   * Finds the largest tracked object with a signature, usually the closest one.
+   *
+   * \param signature
+   *        Signature to look for.
+   * \param out
+   *        Set to the object if one is found.
+   *
+   * \return True if an object was found.
+   */
+  bool find(std::uint32_t signature, track &out) const;
+
+ private:
+  struct filter_track {
+    track info;
+    okapi::ExtendedKalmanFilter<4> filter;  // x, y, x velocity, y velocity
+    int misses;
+  };
+
+  pros::Vision sensor;
+  std::uint32_t signatures[VISION_MAX_SIGNATURES];
+  int signature_count = 0;
+  filter_track active[VISION_MAX_TRACKS];
+  int active_count = 0;
+  std::uint16_t next_id = 0;
+  Snapshot<tracks> published;
+
+  bool is_tracked(std::uint32_t signature) const;
+  void update(const pros::vision_object_s_t *objects, int count, double dt, std::uint32_t now);
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+
+#include "api.h"
+#include "pose_estimator.hpp"
+
+/**
+ * Most distance sensors a relocalizer can use.
+ */
+#define RELOCALIZER_MAX_SENSORS 4
+
+/**
+ * Fixes drift by measuring the field walls with distance sensors.
+ *
+ * When the robot is slow and a sensor points square at a wall, the reading gives the robot's
+ * distance to that wall, which is one exact position component.  Two parallel sensors on the same
+ * wall also give the heading.  Everything found in one pass goes to PoseEstimator::correct() at
+ * once.
+ *
+ * Readings that disagree with the pose by more than set_max_correction() are skipped, those are
+ * game objects or robots in front of the wall.
+ */
+class WallRelocalizer {
+ public:
+  /**
+   * Creates a relocalizer for a pose estimator.
+   *
+   * \param estimator
+   *        Pose to correct.
+   * \param field_half_width
+   *        Distance from the center of the field to the inside of each wall, in inches.
+   */
+  explicit WallRelocalizer(PoseEstimator &estimator, double field_half_width = 70.25);
+
+  /**
+   * Adds a distance sensor.
+   *
+   * \param sensor
+   *        The sensor.
+   * \param forward
+   *        Inches the sensor sits in front of the center of the robot, negative is behind.
+   * \param right
+   *        Inches the sensor sits right of the center of the robot, negative is left.
+   * \param facing
+   *        Degrees clockwise from the front of the robot the sensor points at.  0 front, 90 right,
+   *        180 back, 270 left.
+   */
+  void add_sensor(pros::Distance &sensor, double forward, double right, double facing);
+
+  /**
+   * Reads every sensor once and corrects the pose from the walls they see.
+   *
+   * \return The components that were corrected.
+   */
+  PoseEstimator::pose_fix relocalize();
+
+  /**
+   * Runs relocalize() in a task during autonomous.
+   *
+   * \param period_ms
+   *        Time between passes.  The distance sensor updates every 33 ms.
+   */
+  void start(std::uint32_t period_ms = 50);
+
+  /**
+   * Largest angle between a sensor and the wall's normal that still counts as square, in degrees.
+   */
+  void set_max_angle(double degrees) { max_angle = degrees; }
+
+  /**
+   * Largest reading used, in inches.  The sensor is less accurate far away.
+   */
+  void set_max_range(double inches) { max_range = inches; }
+
+  /**
+   * Robot speed above which no readings are used, in inches per second.
+   */
+  void set_max_speed(double inches_per_second) { max_speed = inches_per_second; }
+
+  /**
+   * Largest correction applied, in inches.
+   */
+  void set_max_correction(double inches) { max_correction = inches; }
+
+ private:
+  struct mount {
+    pros::Distance *sensor;
+    double along;    // Distance from the center of the robot along the beam
+    double lateral;  // Distance from the center of the robot across the beam
+    double facing;
+  };
+
+  PoseEstimator &estimator;
+  const double half_width;
+  mount mounts[RELOCALIZER_MAX_SENSORS];
+  int mount_count = 0;
+  double max_angle = 5;
+  double max_range = 48;
+  double max_speed = 10;
+  double max_correction = 8;
+  int min_confidence = 45;
+};
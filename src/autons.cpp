@@ -29,6 +29,14 @@ void default_constants() {
   chassis.set_pid_constants(&chassis.backward_drivePID, 0.45, 0, 5, 0);
   chassis.set_pid_constants(&chassis.turnPID, 5, 0.003, 35, 15);
   chassis.set_pid_constants(&chassis.swingPID, 7, 0, 45, 0);
+
+  // Inches/s, inches/s^2 and inches/s^3.  Jerk softens the start and end of the acceleration.
+  profiled.set_constraints(60, 120, 600);
+  // Power per inch/s, power per inch/s^2, power to get moving
+  profiled.set_feedforward(127.0 / 60.0, 0, 0);
+  // Degrees/s and degrees/s^2 for turns, then power per degree/s, power per degree/s^2, power to get turning
+  profiled.set_turn_constraints(360, 720);
+  profiled.set_turn_feedforward(127.0 / 600.0, 0, 0);
 }
 
 void exit_condition_defaults() {
@@ -70,6 +78,30 @@ void drive_example() {
 
 
 
+///
+// Profiled Drive Example
+///
+void profiled_drive_example() {
+  // The first parameter is target inches
+  // The robot speeds up and slows down along an S-curve, so it can go full speed and still stop on target
+
+  profiled.set_drive_profile(48);
+  profiled.wait_drive();
+
+  // Constraints can be set for a single motion, here a slower drive back
+  profiled.set_drive_profile(-48, {30, 60, 300});
+  profiled.wait_drive();
+
+  // Turns take the same absolute heading as set_turn_pid(), and always take the same time
+  profiled.set_turn_profile(90);
+  profiled.wait_drive();
+
+  profiled.set_turn_profile(0);
+  profiled.wait_drive();
+}
+
+
+
 ///
 // Turn Example
 ///
@@ -0,0 +1,96 @@
+#include "main.h"
+
+namespace {
+// Value of a curve at this stick position changes with every curve scale
+const double PROBE = 64;
+
+enum e_last { NONE = 0,
+              TANK = 1,
+              ARCADE = 2 };
+}  // namespace
+
+CurveTable::CurveTable(Drive &drive) : drive(drive) {}
+
+void CurveTable::rebuild() {
+  for (int i = 0; i < 256; i++) {
+    left_table[i] = drive.left_curve_function(i - 128);
+    right_table[i] = drive.right_curve_function(i - 128);
+  }
+  left_probe = drive.left_curve_function(PROBE);
+  right_probe = drive.right_curve_function(PROBE);
+  built = true;
+}
+
+void CurveTable::set_left_curve_buttons(pros::controller_digital_e_t decrease, pros::controller_digital_e_t increase) {
+  buttons[0] = decrease;
+  buttons[1] = increase;
+}
+
+void CurveTable::set_right_curve_buttons(pros::controller_digital_e_t decrease, pros::controller_digital_e_t increase) {
+  buttons[2] = decrease;
+  buttons[3] = increase;
+}
+
+// The curve only changes while a curve button is held, so only check it then
+void CurveTable::update() {
+  bool pressed = false;
+  for (auto button : buttons) pressed |= master.get_digital(button);
+
+  if (pressed || was_pressed) {
+    if (drive.left_curve_function(PROBE) != left_probe || drive.right_curve_function(PROBE) != right_probe)
+      rebuild();
+  }
+  was_pressed = pressed;
+}
+
+void CurveTable::tank() {
+  // Let the drive run the first tick itself, it also tells the drive which curve buttons to use
+  if (!built || last != TANK) {
+    drive.tank();
+    rebuild();
+    last = TANK;
+    return;
+  }
+
+  drive.reset_drive_sensors_opcontrol();
+  drive.modify_curve_with_controller();
+  update();
+
+  int l_stick = left(master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y));
+  int r_stick = left(master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y));
+  drive.joy_thresh_opcontrol(l_stick, r_stick);
+}
+
+void CurveTable::arcade_standard(e_type stick_type) {
+  if (!built || last != ARCADE) {
+    drive.arcade_standard(stick_type);
+    rebuild();
+    last = ARCADE;
+    return;
+  }
+
+  drive.reset_drive_sensors_opcontrol();
+  drive.modify_curve_with_controller();
+  update();
+
+  int fwd_stick = left(master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y));
+  int turn_stick = right(master.get_analog(stick_type == SPLIT ? pros::E_CONTROLLER_ANALOG_RIGHT_X : pros::E_CONTROLLER_ANALOG_LEFT_X));
+  drive.joy_thresh_opcontrol(fwd_stick + turn_stick, fwd_stick - turn_stick);
+}
+
+void CurveTable::arcade_flipped(e_type stick_type) {
+  if (!built || last != ARCADE) {
+    drive.arcade_flipped(stick_type);
+    rebuild();
+    last = ARCADE;
+    return;
+  }
+
+  drive.reset_drive_sensors_opcontrol();
+  drive.modify_curve_with_controller();
+  update();
+
+  int fwd_stick = right(master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y));
+  int turn_stick = left(master.get_analog(stick_type == SPLIT ? pros::E_CONTROLLER_ANALOG_LEFT_X : pros::E_CONTROLLER_ANALOG_RIGHT_X));
+  drive.joy_thresh_opcontrol(fwd_stick + turn_stick, fwd_stick - turn_stick);
+}
@@ -0,0 +1,424 @@
+#include "main.h"
+
+namespace {
+const double INCH_TO_METER = 0.0254;
+const std::uint16_t NOT_SEEN = 0xFFFF;
+const std::uint16_t CLOSED = 0xFFFE;
+const double BIN_WIDTH = 2 * M_PI / FIELD_PLANNER_HEADINGS;
+const double SHOT_RANGE = 24;        // Inches from the goal to start trying to drive straight there
+const double SHOT_ANGLE = M_PI / 4;  // Most a straight drive to the goal can turn at either end
+const double TILE = 23.5;
+const double WALL = 70.25;  // Center of the field to the inside of the walls
+
+int bin_of(double heading) {
+  int bin = std::lround(heading / BIN_WIDTH) % FIELD_PLANNER_HEADINGS;
+  return bin < 0 ? bin + FIELD_PLANNER_HEADINGS : bin;
+}
+double angle_between(double a, double b) { return std::fabs(std::remainder(a - b, 2 * M_PI)); }
+double to_rad(double degrees) { return degrees * M_PI / 180; }
+double to_deg(double radians) { return radians * 180 / M_PI; }
+}  // namespace
+
+FieldPlanner::FieldPlanner(double field_half_width)
+    : half_width(field_half_width), cell_size(2 * field_half_width / FIELD_PLANNER_CELLS) {}
+
+void FieldPlanner::add_rectangle(double x1, double y1, double x2, double y2) {
+  int min_x = std::max(0, (int)std::floor((std::min(x1, x2) + half_width) / cell_size));
+  int max_x = std::min(FIELD_PLANNER_CELLS - 1, (int)std::floor((std::max(x1, x2) + half_width) / cell_size));
+  int min_y = std::max(0, (int)std::floor((std::min(y1, y2) + half_width) / cell_size));
+  int max_y = std::min(FIELD_PLANNER_CELLS - 1, (int)std::floor((std::max(y1, y2) + half_width) / cell_size));
+  for (int y = min_y; y <= max_y; y++)
+    for (int x = min_x; x <= max_x; x++) occupied.set(y * FIELD_PLANNER_CELLS + x);
+  dirty = true;
+}
+
+void FieldPlanner::add_circle(double x, double y, double radius) {
+  for (int cell = 0; cell < CELL_COUNT; cell++) {
+    // Closest point of the cell to the center
+    double cell_x = (cell % FIELD_PLANNER_CELLS + 0.5) * cell_size - half_width;
+    double cell_y = (cell / FIELD_PLANNER_CELLS + 0.5) * cell_size - half_width;
+    double dx = std::max(std::fabs(cell_x - x) - cell_size / 2, 0.0);
+    double dy = std::max(std::fabs(cell_y - y) - cell_size / 2, 0.0);
+    if (dx * dx + dy * dy < radius * radius) occupied.set(cell);
+  }
+  dirty = true;
+}
+
+void FieldPlanner::clear_obstacles() {
+  occupied.reset();
+  dirty = true;
+}
+
+void FieldPlanner::set_footprint(double length, double width) {
+  this->length = length;
+  this->width = width;
+  dirty = true;
+}
+
+void FieldPlanner::build() {
+  const int reach = FIELD_PLANNER_MAX_REACH;
+  const double half_cell = cell_size / 2;
+  std::int8_t offsets[(2 * reach + 1) * (2 * reach + 1)][2];
+
+  for (int bin = 0; bin < FIELD_PLANNER_HEADINGS; bin++) {
+    // Every cell offset the footprint overlaps, by separating axes.  The footprint is checked at
+    // the middle and both edges of the bin, so every heading that rounds to it is covered.
+    int count = 0;
+    bool too_large = false;
+    for (int dy = -reach; dy <= reach; dy++) {
+      for (int dx = -reach; dx <= reach; dx++) {
+        double ox = dx * cell_size, oy = dy * cell_size;
+        bool overlaps = false;
+        for (int edge = -1; edge <= 1 && !overlaps; edge++) {
+          double angle = (bin + edge * 0.5) * BIN_WIDTH;
+          double fx = std::sin(angle), fy = std::cos(angle);   // Forward
+          double rx = std::cos(angle), ry = -std::sin(angle);  // Right
+          overlaps = std::fabs(ox) < half_cell + length / 2 * std::fabs(fx) + width / 2 * std::fabs(rx) &&
+                     std::fabs(oy) < half_cell + length / 2 * std::fabs(fy) + width / 2 * std::fabs(ry) &&
+                     std::fabs(ox * fx + oy * fy) < length / 2 + half_cell * (std::fabs(fx) + std::fabs(fy)) &&
+                     std::fabs(ox * rx + oy * ry) < width / 2 + half_cell * (std::fabs(rx) + std::fabs(ry));
+        }
+        if (!overlaps) continue;
+        offsets[count][0] = dx;
+        offsets[count][1] = dy;
+        count++;
+        if (std::abs(dx) == reach || std::abs(dy) == reach) too_large = true;
+      }
+    }
+    if (too_large) printf("FieldPlanner: the footprint is larger than %i cells across\n", 2 * reach - 1);
+
+    // The robot can't stand anywhere its footprint covers an element
+    blocked[bin].reset();
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+      if (!occupied[cell]) continue;
+      int x = cell % FIELD_PLANNER_CELLS, y = cell / FIELD_PLANNER_CELLS;
+      for (int i = 0; i < count; i++) {
+        int robot_x = x - offsets[i][0], robot_y = y - offsets[i][1];
+        if (robot_x >= 0 && robot_x < FIELD_PLANNER_CELLS && robot_y >= 0 && robot_y < FIELD_PLANNER_CELLS)
+          blocked[bin].set(robot_y * FIELD_PLANNER_CELLS + robot_x);
+      }
+    }
+  }
+  dirty = false;
+}
+
+bool FieldPlanner::is_free(const PoseEstimator::pose &pose) {
+  if (dirty) build();
+  return fits(pose.x, pose.y, to_rad(pose.heading));
+}
+
+bool FieldPlanner::plan(const PoseEstimator::pose &start, const PoseEstimator::pose &goal, bool match_heading) {
+  waypoint_count = 0;
+  if (dirty) build();
+  path_start = start;
+  path_goal = goal;
+
+  const double goal_heading = to_rad(goal.heading);
+  int first_state = state_of(start.x, start.y, to_rad(start.heading));
+  if (first_state < 0 || state_of(goal.x, goal.y, goal_heading) < 0) {
+    printf("FieldPlanner: the start or goal is off the field\n");
+    return false;
+  }
+  if (!fits(start.x, start.y, to_rad(start.heading), true)) {
+    printf("FieldPlanner: the robot does not fit at the start\n");
+    return false;
+  }
+  if (match_heading && !fits(goal.x, goal.y, goal_heading, true)) {
+    printf("FieldPlanner: the robot does not fit at the goal\n");
+    return false;
+  }
+
+  // Whether the robot can drive straight from a pose to the goal
+  auto reaches_goal = [&](double x, double y, double heading) {
+    double distance = std::hypot(goal.x - x, goal.y - y);
+    if (distance > SHOT_RANGE) return false;
+    if (distance < cell_size) return !match_heading || angle_between(heading, goal_heading) <= SHOT_ANGLE;
+    double direction = std::atan2(goal.x - x, goal.y - y);
+    if (angle_between(heading, direction) > SHOT_ANGLE) return false;
+    if (match_heading && angle_between(direction, goal_heading) > SHOT_ANGLE) return false;
+    return line_of_sight(x, y, goal.x, goal.y);
+  };
+
+  // Steps are long enough to leave their search cell, and turning steps their heading bin
+  const double step = 2 * cell_size * M_SQRT2 * 1.05;
+  const double turn_step = std::max(step, turn_radius * BIN_WIDTH);
+
+  std::fill(cost, cost + STATE_COUNT, INFINITY);
+  std::fill(heap_index, heap_index + STATE_COUNT, NOT_SEEN);
+  heap_size = 0;
+  const std::uint16_t first = first_state;
+  cost[first] = 0;
+  priority[first] = std::hypot(goal.x - start.x, goal.y - start.y);
+  state_x[first] = start.x;
+  state_y[first] = start.y;
+  state_heading[first] = to_rad(start.heading);
+  parent[first] = first;
+  push(first);
+
+  // The robot can also turn in place before it drives off, as far as it fits each way.  That
+  // costs as much as the distance the wheels turn.
+  for (int direction = -1; direction <= 1; direction += 2) {
+    for (int i = 1; i <= FIELD_PLANNER_HEADINGS / 2; i++) {
+      double heading = to_rad(start.heading) + direction * i * BIN_WIDTH;
+      if (!fits(start.x, start.y, heading)) break;
+      std::uint16_t turned = state_of(start.x, start.y, heading);
+      float turned_cost = i * BIN_WIDTH * width / 2;
+      if (turned == first || turned_cost >= cost[turned]) continue;
+      cost[turned] = turned_cost;
+      priority[turned] = turned_cost + priority[first];
+      state_x[turned] = start.x;
+      state_y[turned] = start.y;
+      state_heading[turned] = std::remainder(heading, 2 * M_PI);
+      parent[turned] = first;
+      if (heap_index[turned] == NOT_SEEN)
+        push(turned);
+      else
+        sift_up(heap_index[turned]);
+    }
+  }
+
+  int found = -1;
+  for (int expansions = 0; heap_size > 0; expansions++) {
+    if (expansions >= max_expansions) {
+      printf("FieldPlanner: gave up after %i expansions\n", expansions);
+      return false;
+    }
+    std::uint16_t state = pop();
+    heap_index[state] = CLOSED;
+    double x = state_x[state], y = state_y[state], heading = state_heading[state];
+    if (reaches_goal(x, y, heading)) {
+      found = state;
+      break;
+    }
+
+    for (int turn = -1; turn <= 1; turn++) {
+      // Arc of the step, turning clockwise for positive curvature
+      double curvature = turn / turn_radius;
+      double arc = turn ? turn_step : step;
+      double next_x = x, next_y = y, next_heading = heading;
+      bool clear = true;
+      int samples = (int)std::ceil(arc / (cell_size / 2));
+      for (int i = 1; i <= samples && clear; i++) {
+        double distance = arc * i / samples;
+        next_heading = heading + distance * curvature;
+        if (turn == 0) {
+          next_x = x + distance * std::sin(heading);
+          next_y = y + distance * std::cos(heading);
+        } else {
+          next_x = x + (std::cos(heading) - std::cos(next_heading)) / curvature;
+          next_y = y + (std::sin(next_heading) - std::sin(heading)) / curvature;
+        }
+        clear = fits(next_x, next_y, next_heading, true);
+      }
+      if (!clear) continue;
+      int next_state = state_of(next_x, next_y, next_heading);
+      if (next_state < 0) continue;
+      std::uint16_t next = next_state;
+      if (heap_index[next] == CLOSED) continue;
+
+      float next_cost = cost[state] + arc + (turn ? turn_cost : 0);
+      if (next_cost >= cost[next]) continue;
+      cost[next] = next_cost;
+      priority[next] = next_cost + std::hypot(goal.x - next_x, goal.y - next_y);
+      state_x[next] = next_x;
+      state_y[next] = next_y;
+      state_heading[next] = std::remainder(next_heading, 2 * M_PI);
+      parent[next] = state;
+      if (heap_index[next] == NOT_SEEN)
+        push(next);
+      else
+        sift_up(heap_index[next]);
+    }
+  }
+  if (found < 0) {
+    printf("FieldPlanner: no path to the goal\n");
+    return false;
+  }
+
+  // The heap is free now, reuse it for the states from the start, then the goal after them
+  std::uint16_t *path = heap;
+  int path_length = 0;
+  for (std::uint16_t state = found;; state = parent[state]) {
+    path[path_length++] = state;
+    if (state == first) break;
+  }
+  std::reverse(path, path + path_length);
+  double start_heading = start.heading;
+  if (path_length > 1 && state_x[path[1]] == state_x[first] && state_y[path[1]] == state_y[first]) {
+    // Turned in place first
+    start_heading = to_deg(state_heading[path[1]]);
+    path++;
+    path_length--;
+  }
+  auto point_x = [&](int i) { return i == path_length ? goal.x : (double)state_x[path[i]]; };
+  auto point_y = [&](int i) { return i == path_length ? goal.y : (double)state_y[path[i]]; };
+
+  // Keep only the corners of the straightest path through the states
+  waypoints[waypoint_count++] = {start.x, start.y, start_heading};
+  for (int anchor = 0; anchor < path_length;) {
+    int next = anchor + 1;
+    while (next < path_length && line_of_sight(point_x(anchor), point_y(anchor), point_x(next + 1), point_y(next + 1)))
+      next++;
+    if (waypoint_count >= FIELD_PLANNER_MAX_WAYPOINTS) {
+      printf("FieldPlanner: the path needs more than %i waypoints\n", FIELD_PLANNER_MAX_WAYPOINTS);
+      waypoint_count = 0;
+      return false;
+    }
+    waypoints[waypoint_count++] = {point_x(next), point_y(next), 0};
+    anchor = next;
+  }
+
+  // Corners face halfway between the segments on either side
+  for (int i = 1; i < waypoint_count; i++) {
+    const PoseEstimator::pose &before = waypoints[i - 1];
+    PoseEstimator::pose &corner = waypoints[i];
+    double in_x = corner.x - before.x, in_y = corner.y - before.y;
+    double in_length = std::hypot(in_x, in_y);
+    if (in_length > 0) {
+      in_x /= in_length;
+      in_y /= in_length;
+    }
+    double out_x = 0, out_y = 0;
+    if (i + 1 < waypoint_count) {
+      out_x = waypoints[i + 1].x - corner.x;
+      out_y = waypoints[i + 1].y - corner.y;
+      double out_length = std::hypot(out_x, out_y);
+      if (out_length > 0) {
+        out_x /= out_length;
+        out_y /= out_length;
+      }
+    }
+    corner.heading = to_deg(std::atan2(in_x + out_x, in_y + out_y));
+  }
+  if (match_heading) waypoints[waypoint_count - 1].heading = goal.heading;
+  return true;
+}
+
+std::vector<squiggles::Pose> FieldPlanner::to_squiggles() const {
+  std::vector<squiggles::Pose> poses;
+  poses.reserve(waypoint_count);
+  for (int i = 0; i < waypoint_count; i++)
+    poses.emplace_back(waypoints[i].x * INCH_TO_METER, waypoints[i].y * INCH_TO_METER,
+                       M_PI / 2 - to_rad(waypoints[i].heading));
+  return poses;
+}
+
+int FieldPlanner::cell_of(double x, double y) const {
+  int cell_x = (int)std::floor((x + half_width) / cell_size);
+  int cell_y = (int)std::floor((y + half_width) / cell_size);
+  if (cell_x < 0 || cell_x >= FIELD_PLANNER_CELLS || cell_y < 0 || cell_y >= FIELD_PLANNER_CELLS) return -1;
+  return cell_y * FIELD_PLANNER_CELLS + cell_x;
+}
+
+int FieldPlanner::state_of(double x, double y, double heading) const {
+  int cell_x = (int)std::floor((x + half_width) / (2 * cell_size));
+  int cell_y = (int)std::floor((y + half_width) / (2 * cell_size));
+  if (cell_x < 0 || cell_x >= SEARCH_CELLS || cell_y < 0 || cell_y >= SEARCH_CELLS) return -1;
+  return (cell_y * SEARCH_CELLS + cell_x) * FIELD_PLANNER_HEADINGS + bin_of(heading);
+}
+
+bool FieldPlanner::fits(double x, double y, double heading, bool near_ends) const {
+  // The walls are exact, the rotated footprint's extent along each axis.  Near the ends of a path
+  // only the sides have to clear them.
+  bool brush_walls = near_ends && (std::hypot(x - path_start.x, y - path_start.y) < length ||
+                                   std::hypot(x - path_goal.x, y - path_goal.y) < length);
+  double across = std::fabs(std::sin(heading)), along = std::fabs(std::cos(heading));
+  double extent_x = brush_walls ? width / 2 : length / 2 * across + width / 2 * along;
+  double extent_y = brush_walls ? width / 2 : length / 2 * along + width / 2 * across;
+  if (std::fabs(x) + extent_x > half_width || std::fabs(y) + extent_y > half_width) return false;
+  int cell = cell_of(x, y);
+  return cell >= 0 && !blocked[bin_of(heading)][cell];
+}
+
+bool FieldPlanner::line_of_sight(double x1, double y1, double x2, double y2) const {
+  double dx = x2 - x1, dy = y2 - y1;
+  double heading = std::atan2(dx, dy);
+  if (!fits(x1, y1, heading, true) || !fits(x2, y2, heading, true)) return false;
+
+  // Checks the middle of each piece of the line inside one cell, so no cell it crosses is missed.
+  // next_x and next_y are how far along the line it crosses the next cell edge on each axis.
+  double next_x = INFINITY, next_y = INFINITY, delta_x = INFINITY, delta_y = INFINITY;
+  if (dx != 0) {
+    double edge = (std::floor((x1 + half_width) / cell_size) + (dx > 0)) * cell_size - half_width;
+    next_x = (edge - x1) / dx;
+    delta_x = cell_size / std::fabs(dx);
+  }
+  if (dy != 0) {
+    double edge = (std::floor((y1 + half_width) / cell_size) + (dy > 0)) * cell_size - half_width;
+    next_y = (edge - y1) / dy;
+    delta_y = cell_size / std::fabs(dy);
+  }
+  for (double t = 0; t < 1;) {
+    double exit = std::min({next_x, next_y, 1.0});
+    double middle = (t + exit) / 2;
+    if (!fits(x1 + dx * middle, y1 + dy * middle, heading, true)) return false;
+    if (next_x < next_y)
+      next_x += delta_x;
+    else
+      next_y += delta_y;
+    t = exit;
+  }
+  return true;
+}
+
+void FieldPlanner::push(std::uint16_t state) {
+  heap[heap_size] = state;
+  heap_index[state] = heap_size;
+  sift_up(heap_size++);
+}
+
+std::uint16_t FieldPlanner::pop() {
+  std::uint16_t top = heap[0];
+  heap[0] = heap[--heap_size];
+  heap_index[heap[0]] = 0;
+  sift_down(0);
+  return top;
+}
+
+void FieldPlanner::sift_up(int i) {
+  while (i > 0 && priority[heap[i]] < priority[heap[(i - 1) / 2]]) {
+    std::swap(heap[i], heap[(i - 1) / 2]);
+    heap_index[heap[i]] = i;
+    heap_index[heap[(i - 1) / 2]] = (i - 1) / 2;
+    i = (i - 1) / 2;
+  }
+}
+
+void FieldPlanner::sift_down(int i) {
+  while (true) {
+    int best = i;
+    for (int child = 2 * i + 1; child <= 2 * i + 2 && child < heap_size; child++)
+      if (priority[heap[child]] < priority[heap[best]]) best = child;
+    if (best == i) return;
+    std::swap(heap[i], heap[best]);
+    heap_index[heap[i]] = i;
+    heap_index[heap[best]] = best;
+    i = best;
+  }
+}
+
+void add_over_under_field(FieldPlanner &planner, bool short_barriers) {
+  // Goals, a tile deep and two tiles wide, at the middle of both end walls
+  planner.add_rectangle(-TILE, WALL - TILE, TILE, WALL);
+  planner.add_rectangle(-TILE, -WALL, TILE, -(WALL - TILE));
+
+  // The long barrier across the two middle tiles, the short barriers from it to the elevation bars
+  planner.add_rectangle(-TILE, -1.5, TILE, 1.5);
+  if (short_barriers) {
+    planner.add_rectangle(-WALL, -1.25, -TILE, 1.25);
+    planner.add_rectangle(TILE, -1.25, WALL, 1.25);
+  }
+
+  // Elevation bar posts at the middle of both side walls
+  planner.add_rectangle(-WALL, -3, -(WALL - 5), 3);
+  planner.add_rectangle(WALL - 5, -3, WALL, 3);
+
+  // Match load bars, diagonal across each corner tile
+  for (int corner = 0; corner < 4; corner++) {
+    double sign_x = corner % 2 ? 1 : -1, sign_y = corner / 2 ? 1 : -1;
+    for (int i = 0; i <= 6; i++) {
+      double along = TILE * i / 6;
+      planner.add_circle(sign_x * (WALL - along), sign_y * (WALL - TILE + along), 1.5);
+    }
+  }
+}
@@ -0,0 +1,96 @@
+#include "main.h"
+
+namespace {
+const int PROXIMITY_HYSTERESIS = 50;
+const int DEBOUNCE_SAMPLES = 2;  // Readings in a row before an object counts as arrived or gone
+}  // namespace
+
+Intake::Intake(pros::Motor &left, pros::Motor &right, std::uint8_t optical_port)
+    : left(left), right(right), optical(optical_port), task([this] { this->intake_task(); }) {}
+
+void Intake::set_mode(e_mode new_mode) {
+  mutex.take();
+  if (new_mode != IDLE) start_captures = captures.load();
+  mode = new_mode;
+  int power = new_mode == IDLE ? 0 : (new_mode == OUTTAKE ? -speed : speed);
+  left = power;
+  right = -power;
+  mutex.give();
+}
+
+void Intake::intake(bool stop_on_capture) { set_mode(stop_on_capture ? CAPTURE : INTAKE); }
+
+void Intake::index() { set_mode(INDEX); }
+
+void Intake::outtake() { set_mode(OUTTAKE); }
+
+void Intake::stop() { set_mode(IDLE); }
+
+void Intake::set_hue_range(double min, double max) {
+  hue_min = min;
+  hue_max = max;
+  use_hue = true;
+}
+
+bool Intake::wait_for_object(std::uint32_t timeout_ms) {
+  std::uint32_t start = pros::millis();
+  while (captures == start_captures) {
+    if (pros::millis() - start >= timeout_ms) return false;
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  return true;
+}
+
+bool Intake::wait_until_idle(std::uint32_t timeout_ms) {
+  std::uint32_t start = pros::millis();
+  while (mode != IDLE) {
+    if (pros::millis() - start >= timeout_ms) return false;
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  return true;
+}
+
+double Intake::throughput(std::uint32_t window_ms) {
+  mutex.take();
+  std::uint32_t now = pros::millis();
+  std::uint32_t stored = std::min<std::uint32_t>(captures, INTAKE_HISTORY_SIZE);
+  int recent = 0;
+  for (std::uint32_t i = 0; i < stored; i++)
+    if (now - capture_times[i] <= window_ms) recent++;
+  mutex.give();
+  return recent * 1000.0 / window_ms;
+}
+
+void Intake::intake_task() {
+  int profiler_id = profiler::add_task("Intake", 500, ez::util::DELAY_TIME);
+  std::uint32_t now = pros::millis();
+  while (true) {
+    profiler::loop_begin(profiler_id);
+
+    std::int32_t proximity = optical.get_proximity();
+    bool seen = proximity != PROS_ERR && proximity >= (present ? proximity_threshold - PROXIMITY_HYSTERESIS : proximity_threshold);
+    // Color only matters when an object arrives
+    if (seen && !present && use_hue) {
+      double hue = optical.get_hue();
+      seen = hue_min <= hue_max ? hue >= hue_min && hue <= hue_max : hue >= hue_min || hue <= hue_max;
+    }
+
+    streak = seen == present ? 0 : streak + 1;
+    if (streak >= DEBOUNCE_SAMPLES) {
+      streak = 0;
+      present = seen;
+      if (seen) {
+        mutex.take();
+        capture_times[captures % INTAKE_HISTORY_SIZE] = pros::millis();
+        captures++;
+        mutex.give();
+      } else if (mode == INDEX) {
+        stop();  // Object made it past the sensor
+      }
+    }
+    if (mode == CAPTURE && captures != start_captures) stop();
+
+    profiler::loop_end(profiler_id);
+    pros::Task::delay_until(&now, ez::util::DELAY_TIME);
+  }
+}
@@ -17,6 +17,11 @@ pros::Motor puncher (9, pros::E_MOTOR_GEARSET_36, true, pros::E_MOTOR_ENCODER_DE
 pros::Motor intakeLeft (6, pros::E_MOTOR_GEARSET_36, false, pros::E_MOTOR_ENCODER_DEGREES);
 pros::Motor intakeRight (7, pros::E_MOTOR_GEARSET_36, false, pros::E_MOTOR_ENCODER_DEGREES);
 pros::Imu imu_sensor(19);
+const int INTAKE_OPTICAL_PORT = 10;
+
+// Intake watched by the optical sensor.  Without the sensor it never sees an object, so waits on it
+// time out like the old delays did.
+Intake intake(intakeLeft, intakeRight, INTAKE_OPTICAL_PORT);
 
 // Chassis constructor
 Drive chassis (
@@ -61,6 +66,26 @@ Drive chassis (
   // ,1
 );
 
+// Joystick curves precomputed from the chassis, use these instead of chassis.tank() and friends
+CurveTable curves(chassis);
+
+// S-curve straight drives on the chassis, use these instead of chassis.set_drive_pid() for fast drives
+ProfiledDrive profiled(chassis);
+
+// Absolute field pose from odometry, the IMU and a GPS sensor.  Uncomment with the GPS port and track width.
+// pros::Gps gps_sensor(GPS_PORT);
+// PoseEstimator pose_estimator(chassis, 11.5, gps_sensor);
+
+// Distance sensors that square the pose up against the field walls, add them in initialize()
+// pros::Distance right_front_distance(RIGHT_FRONT_PORT), right_back_distance(RIGHT_BACK_PORT);
+// WallRelocalizer relocalizer(pose_estimator);
+
+// Game objects seen by the vision sensor, add signatures and start it in initialize()
+// VisionTracker vision_tracker(VISION_PORT);
+
+// Obstacle-free waypoints across the field for SplineGenerator, filled in and built in initialize()
+FieldPlanner field_planner;
+
 bool isShot = false;
 bool morePower = true;
 bool intakeForward = true;
@@ -112,25 +137,31 @@ void shoot() {
   isShot = true;
 };
 
+// One pass of the puncher logic, run every 10ms by the Punch task.
+// Firing holds the motor for 100ms without blocking, so the task never sleeps inside a loop.
+std::uint32_t fireUntil = 0;
 void shootAndPullBackPunch() {
-   while(true) {
-    if (instaShoot) {
+  if (instaShoot) {
+    puncher = 127;
+  } else if (fireUntil != 0) {
+    if (pros::millis() < fireUntil) {
       puncher = 127;
     } else {
-      if (isShot && limitSwitch.get_value()) {
-        puncher = 127;
-        pros::delay(100);
-        isShot = false;
-        puncher = 0;
-      } else if (!isShot && limitSwitch.get_value()) {
-        // if the puncher has punched and the limit switch is not hit, retract the puncher
-        puncher = 0;
-      } else if (!isShot && !limitSwitch.get_value()) {
-        // if the puncher has not punched and the limit switch is hit, stop the motor
-        puncher = 127;
-      } 
-    }  
-    pros::delay(10);  // Delay to prevent wasting resources on the V5 Brain
+      fireUntil = 0;
+      isShot = false;
+      puncher = 0;
+    }
+  } else {
+    if (isShot && limitSwitch.get_value()) {
+      puncher = 127;
+      fireUntil = pros::millis() + 100;
+    } else if (!isShot && limitSwitch.get_value()) {
+      // if the puncher has punched and the limit switch is not hit, retract the puncher
+      puncher = 0;
+    } else if (!isShot && !limitSwitch.get_value()) {
+      // if the puncher has not punched and the limit switch is hit, stop the motor
+      puncher = 127;
+    }
   }
 }
 void setSpeed(int speed) {
@@ -138,7 +169,7 @@ void setSpeed(int speed) {
   intakeRight = -1 * speed;
 }
 
-pros::Task Punch(shootAndPullBackPunch);
+pros::Task Punch = profiler::create_task(shootAndPullBackPunch, "Punch", 1000, ez::util::DELAY_TIME);
 
 const int DRIVE_SPEED = 110; // This is 110/127 (around 87% of max speed).  We don't suggest making this 127.
                              // If this is 127 and the robot tries to heading correct, it's only correcting by
@@ -249,11 +280,11 @@ void defense() {
   chassis.wait_drive();
   intakeAhead();
   pros::delay(100);
-  runIntakeForward();
-  pros::delay(1500);
+  intake.intake(false); // Keeps running through the retract, like before
+  intake.wait_for_object(1500); // Corner ball is in
   intakeRetract();
   pros::delay(100);
-  stopIntake();
+  intake.stop();
   chassis.set_drive_pid(-10, DRIVE_SPEED, true);
   chassis.wait_drive();
   chassis.set_turn_pid(180, TURN_SPEED);
@@ -332,6 +363,13 @@ void initialize() {
   intakeLeft.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
   intakeRight.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
   Punch.resume();
+  // profiler::start_report_task(5000); // Prints task loop times to the terminal every 5 seconds
+  // telemetry::start_writer(); // Drains telemetry channels to the SD card
+  // telemetry::start_drive_stream(chassis); telemetry::start_serial_writer(); // Binary drive PID stream, read it with tools/telemetry_decode
+  // relocalizer.add_sensor(right_front_distance, 5, 6, 90); relocalizer.add_sensor(right_back_distance, -5, 6, 90); relocalizer.start(); // Wall relocalization in autonomous
+  // vision_tracker.add_signature(1); vision_tracker.start(); // Tracks signature 1, read with vision_tracker.find()
+  add_over_under_field(field_planner);
+  field_planner.build(); // Keeps the footprint inflation out of autonomous, set_footprint() before this
 }
 
 
@@ -363,7 +401,9 @@ void autonomous() {
   chassis.reset_pid_targets(); // Resets PID targets to 0
   chassis.reset_gyro(); // Reset gyro position to 0
   chassis.reset_drive_sensor(); // Reset drive sensors to 0
+  // pose_estimator.reset_sensors(); // Replaces the two resets above when the pose estimator is on, so the pose doesn't jump
   chassis.set_drive_brake(pros::E_MOTOR_BRAKE_HOLD); // Set motors to hold.  This helps autonomous consistency.
+  // replay::start_recorder(chassis); // Records every drive tick to the SD card, check it later with replay::verify()
   ez::as::auton_selector.call_selected_auton(); // Calls selected auton from autonomous selector.
 }
 
@@ -380,12 +420,17 @@ void opcontrol() {
 
   Punch.resume();
 
+  static int opcontrol_id = profiler::add_task("opcontrol", 2000, ez::util::DELAY_TIME);
+
   while (true) {
-    chassis.tank(); // Tank control
-    // chassis.arcade_standard(ez::SPLIT); // Standard split arcade
-    // chassis.arcade_standard(ez::SINGLE); // Standard single arcade
-    // chassis.arcade_flipped(ez::SPLIT); // Flipped split arcade
-    // chassis.arcade_flipped(ez::SINGLE); // Flipped single arcade
+    profiler::loop_begin(opcontrol_id);
+    int debounce = 0;
+
+    curves.tank(); // Tank control
+    // curves.arcade_standard(ez::SPLIT); // Standard split arcade
+    // curves.arcade_standard(ez::SINGLE); // Standard single arcade
+    // curves.arcade_flipped(ez::SPLIT); // Flipped split arcade
+    // curves.arcade_flipped(ez::SINGLE); // Flipped single arcade
     if (master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) {
       instaShoot = !instaShoot;
       if (instaShoot) {
@@ -393,12 +438,12 @@ void opcontrol() {
       } else if (!instaShoot) {
         master.print(0, 0, "Instashoot OFF");
       };
-      pros::delay(delay);
+      debounce = delay;
     }
     // Shoot
     if (master.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) {
       shoot();
-      pros::delay(delay);
+      debounce = delay;
     }
 
     // Toggle Intake Code
@@ -447,33 +492,33 @@ void opcontrol() {
       intakeAhead();
       leftIntakeAhead = true;
       rightIntakeAhead = true;
-      pros::delay(delay);
+      debounce = delay;
     } else if (master.get_digital(pros::E_CONTROLLER_DIGITAL_UP) && (leftIntakeAhead || rightIntakeAhead)) {
       intakeRetract();
       leftIntakeAhead = false;
       rightIntakeAhead = false;
-      pros::delay(delay);
+      debounce = delay;
     } 
     if (master.get_digital(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
       intakeRightPneumatic.set_value(true);
       rightIntakeAhead = true;
-      pros::delay(delay);
+      debounce = delay;
     } 
     if (master.get_digital(pros::E_CONTROLLER_DIGITAL_LEFT)) {
       intakeLeftPneumatic.set_value(true);
       leftIntakeAhead = true;
-      pros::delay(delay);
+      debounce = delay;
     }
 
     // WALL Logic
     if (master.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN) && !isWallUp) {
       wallUp();
       isWallUp = true;
-      pros::delay(delay);
+      debounce = delay;
     } else if (master.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN) && isWallUp) {
       wallDown();
       isWallUp = false;
-      pros::delay(delay);
+      debounce = delay;
     }
     
     // PTO Logic
@@ -481,14 +526,17 @@ void opcontrol() {
       ptoLeft.set_value(true);
       ptoRight.set_value(true);
       isPTO = true;
-      pros::delay(delay);
+      debounce = delay;
     } else if (master.get_digital(pros::E_CONTROLLER_DIGITAL_Y) && isPTO) {
       ptoRight.set_value(false);
       ptoRight.set_value(false);
       isPTO = false;
-      pros::delay(delay);
+      debounce = delay;
     }
 
+    profiler::loop_end(opcontrol_id);
+    // Button debounce waits after the timed region, so the profiler only sees the loop's own work
+    if (debounce != 0) pros::delay(debounce);
     pros::delay(ez::util::DELAY_TIME); // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
   }
 }
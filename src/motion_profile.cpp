@@ -0,0 +1,85 @@
+#include "main.h"
+
+#include <cmath>
+
+namespace {
+// Jerk time, constant acceleration time and acceleration reached on the way up to velocity v
+void ramp_times(double v, double accel, double jerk, double &t_jerk, double &t_accel, double &reached) {
+  if (jerk <= 0) {
+    t_jerk = 0;
+    t_accel = v / accel;
+    reached = accel;
+  } else if (v * jerk < accel * accel) {
+    // Never reaches max acceleration
+    t_jerk = std::sqrt(v / jerk);
+    t_accel = 0;
+    reached = jerk * t_jerk;
+  } else {
+    t_jerk = accel / jerk;
+    t_accel = v / accel - t_jerk;
+    reached = accel;
+  }
+}
+
+// Highest velocity that can be reached and stopped from within distance
+double reachable_velocity(double distance, double accel, double jerk) {
+  if (jerk <= 0) return std::sqrt(distance * accel);
+
+  double v_cross = accel * accel / jerk;
+  if (distance <= v_cross * 2 * accel / jerk)
+    return std::cbrt(distance * distance * jerk / 4);
+  return accel / 2 * (-accel / jerk + std::sqrt(accel * accel / (jerk * jerk) + 4 * distance / accel));
+}
+}  // namespace
+
+SCurveProfile::SCurveProfile(double distance, double max_velocity, double max_acceleration, double max_jerk) {
+  sign = distance < 0 ? -1 : 1;
+  double d = std::fabs(distance);
+  if (d == 0 || max_velocity <= 0 || max_acceleration <= 0) return;
+
+  double t_jerk, t_accel, reached;
+  peak = max_velocity;
+  ramp_times(peak, max_acceleration, max_jerk, t_jerk, t_accel, reached);
+  if (peak * (2 * t_jerk + t_accel) > d) {
+    peak = reachable_velocity(d, max_acceleration, max_jerk);
+    ramp_times(peak, max_acceleration, max_jerk, t_jerk, t_accel, reached);
+  }
+  double t_cruise = std::fmax(0, d / peak - (2 * t_jerk + t_accel));
+
+  double durations[7] = {t_jerk, t_accel, t_jerk, t_cruise, t_jerk, t_accel, t_jerk};
+  double accels[7] = {0, reached, reached, 0, 0, -reached, -reached};
+  double j = t_jerk > 0 ? reached / t_jerk : 0;
+  double segment_jerks[7] = {j, 0, -j, 0, -j, 0, j};
+
+  for (int i = 0; i < 7; i++) {
+    jerks[i] = segment_jerks[i];
+    starts[i].acceleration = accels[i];
+
+    // Integrate this segment to get where the next one starts
+    double t = durations[i];
+    const state &s = starts[i];
+    starts[i + 1].position = s.position + s.velocity * t + s.acceleration * t * t / 2 + jerks[i] * t * t * t / 6;
+    starts[i + 1].velocity = s.velocity + s.acceleration * t + jerks[i] * t * t / 2;
+    start_times[i + 1] = start_times[i] + t;
+  }
+  starts[7].acceleration = 0;
+}
+
+SCurveProfile::state SCurveProfile::sample(double t) const {
+  state out;
+  if (t <= 0) return out;
+
+  if (t >= duration()) {
+    out.position = sign * starts[7].position;
+    return out;
+  }
+
+  int i = 0;
+  while (i < 6 && t >= start_times[i + 1]) i++;
+  double dt = t - start_times[i];
+  const state &s = starts[i];
+  out.position = sign * (s.position + s.velocity * dt + s.acceleration * dt * dt / 2 + jerks[i] * dt * dt * dt / 6);
+  out.velocity = sign * (s.velocity + s.acceleration * dt + jerks[i] * dt * dt / 2);
+  out.acceleration = sign * (s.acceleration + jerks[i] * dt);
+  return out;
+}
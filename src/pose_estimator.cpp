@@ -0,0 +1,185 @@
+#include "main.h"
+
+using okapi::DiffDriveProcessModel;
+
+namespace {
+const double METER_TO_INCH = 39.3701;
+const double DT = ez::util::DELAY_TIME / 1000.0;
+
+// Noise, in inches, radians and seconds
+const double ACCEL_STD_DEV = 60;
+const double ANGULAR_ACCEL_STD_DEV = 10;
+const double WHEEL_VARIANCE = 2.0 * 2.0;
+const double IMU_VARIANCE = 0.005 * 0.005;
+const double GPS_MIN_ERROR = 0.5;  // The GPS can report 0, never trust it that much
+const double GPS_GATE = 11.3;      // 99% of good 3 axis readings pass
+const int GPS_GATE_RECOVER = 10;   // This many gated readings in a row means the pose is wrong, not the GPS
+
+// More than this in one tick can only be a sensor reset
+const double MAX_STEP = 3;
+const double MAX_TURN_STEP = 30;
+
+// Field heading (degrees clockwise from +y) to and from the filter's theta (radians counterclockwise from +x)
+double to_theta(double heading) { return DiffDriveProcessModel::wrapAngle((90 - heading) * M_PI / 180); }
+double to_heading(double theta) {
+  double heading = std::fmod(90 - theta * 180 / M_PI, 360);
+  return heading < 0 ? heading + 360 : heading;
+}
+}  // namespace
+
+PoseEstimator::PoseEstimator(Drive &drive, double track_width)
+    : drive(drive),
+      model(track_width, ACCEL_STD_DEV, ANGULAR_ACCEL_STD_DEV),
+      gps_latency_ticks(0),
+      task([this] { this->estimate_task(); }) {}
+
+PoseEstimator::PoseEstimator(Drive &drive, double track_width, pros::Gps &gps, std::uint32_t gps_latency_ms)
+    : drive(drive),
+      gps(&gps),
+      model(track_width, ACCEL_STD_DEV, ANGULAR_ACCEL_STD_DEV),
+      gps_latency_ticks(gps_latency_ms / ez::util::DELAY_TIME),
+      task([this] { this->estimate_task(); }) {}
+
+void PoseEstimator::set_pose(pose new_pose) {
+  mutex.take();
+  heading_offset = new_pose.heading - drive.get_gyro();
+  okapi::Vector<5> x = {new_pose.x, new_pose.y, to_theta(new_pose.heading), 0, 0};
+  ekf.reset(x, okapi::Matrix<5, 5>::diagonal({1e-6, 1e-6, 1e-6, 1, 1}));
+  for (auto &state : history) state = x;
+  mutex.give();
+}
+
+void PoseEstimator::reset_sensors() {
+  mutex.take();
+  drive.reset_gyro();
+  drive.reset_drive_sensor();
+  heading_offset += last_gyro - drive.get_gyro();
+  last_gyro = drive.get_gyro();
+  last_left = drive.left_sensor();
+  last_right = drive.right_sensor();
+  mutex.give();
+}
+
+void PoseEstimator::correct(const pose_fix &fix) {
+  using okapi::Matrix;
+  using okapi::Vector;
+  double position_variance = fix.position_error * fix.position_error;
+  double heading_variance = std::pow(fix.heading_error * M_PI / 180, 2);
+
+  mutex.take();
+  const Vector<5> &x = ekf.getState();
+  if (fix.has_heading) {
+    Matrix<1, 5> H;
+    H(0, DiffDriveProcessModel::THETA) = 1;
+    ekf.update<1>({DiffDriveProcessModel::wrapAngle(to_theta(fix.heading) - x[DiffDriveProcessModel::THETA])}, H, {heading_variance});
+    heading_offset = to_heading(x[DiffDriveProcessModel::THETA]) - last_gyro;
+  }
+  if (fix.has_x) {
+    Matrix<1, 5> H;
+    H(0, DiffDriveProcessModel::X) = 1;
+    ekf.update<1>({fix.x - x[DiffDriveProcessModel::X]}, H, {position_variance});
+  }
+  if (fix.has_y) {
+    Matrix<1, 5> H;
+    H(0, DiffDriveProcessModel::Y) = 1;
+    ekf.update<1>({fix.y - x[DiffDriveProcessModel::Y]}, H, {position_variance});
+  }
+  mutex.give();
+}
+
+PoseEstimator::pose PoseEstimator::get_pose() {
+  mutex.take();
+  okapi::Vector<5> x = ekf.getState();
+  mutex.give();
+  return {x[DiffDriveProcessModel::X], x[DiffDriveProcessModel::Y], to_heading(x[DiffDriveProcessModel::THETA])};
+}
+
+double PoseEstimator::get_velocity() {
+  mutex.take();
+  double velocity = ekf.getState()[DiffDriveProcessModel::V];
+  mutex.give();
+  return velocity;
+}
+
+void PoseEstimator::set_gps_max_error(double inches) { gps_max_error = inches; }
+
+void PoseEstimator::set_gps_heading_error(double degrees) { gps_heading_error = degrees; }
+
+void PoseEstimator::estimate_task() {
+  last_left = drive.left_sensor();
+  last_right = drive.right_sensor();
+  last_gyro = drive.get_gyro();
+
+  std::uint32_t now = pros::millis();
+  while (true) {
+    int left = drive.left_sensor();
+    int right = drive.right_sensor();
+    double gyro = drive.get_gyro();
+    double tick_per_inch = drive.get_tick_per_inch();
+    double left_step = (left - last_left) / tick_per_inch;
+    double right_step = (right - last_right) / tick_per_inch;
+
+    mutex.take();
+    // Catches sensor resets that didn't go through reset_sensors(), but only big ones
+    bool encoder_reset = std::fabs(left_step) > MAX_STEP || std::fabs(right_step) > MAX_STEP;
+    if (std::fabs(gyro - last_gyro) > MAX_TURN_STEP) heading_offset += last_gyro - gyro;
+    last_left = left;
+    last_right = right;
+    last_gyro = gyro;
+
+    model.predict(ekf, DT);
+    if (!encoder_reset) model.updateWheels(ekf, left_step / DT, right_step / DT, WHEEL_VARIANCE);
+
+    okapi::Matrix<1, 5> H;
+    H(0, DiffDriveProcessModel::THETA) = 1;
+    double theta = ekf.getState()[DiffDriveProcessModel::THETA];
+    ekf.update<1>({DiffDriveProcessModel::wrapAngle(to_theta(gyro + heading_offset) - theta)}, H, {IMU_VARIANCE});
+
+    history[history_index % POSE_HISTORY_SIZE] = ekf.getState();
+    history_index++;
+    if (gps) gps_update();
+    mutex.give();
+
+    pros::Task::delay_until(&now, ez::util::DELAY_TIME);
+  }
+}
+
+// Called with the mutex taken
+void PoseEstimator::gps_update() {
+  pros::c::gps_status_s_t status = gps->get_status();
+  if (!std::isfinite(status.x) || (status.x == last_gps_x && status.y == last_gps_y)) return;
+  last_gps_x = status.x;
+  last_gps_y = status.y;
+
+  double error = gps->get_error() * METER_TO_INCH;
+  double heading = gps->get_heading();
+  if (!std::isfinite(error) || !std::isfinite(heading) || error > gps_max_error) {
+    rejected++;
+    return;
+  }
+  error = std::fmax(error, GPS_MIN_ERROR);
+
+  // Compare against where the filter thought the robot was when the GPS saw it
+  std::uint32_t latency = std::min({gps_latency_ticks, history_index - 1, (std::uint32_t)POSE_HISTORY_SIZE - 1});
+  const okapi::Vector<5> &past = history[(history_index - 1 - latency) % POSE_HISTORY_SIZE];
+
+  okapi::Vector<3> innovation = {status.x * METER_TO_INCH - past[DiffDriveProcessModel::X],
+                                 status.y * METER_TO_INCH - past[DiffDriveProcessModel::Y],
+                                 DiffDriveProcessModel::wrapAngle(to_theta(heading) - past[DiffDriveProcessModel::THETA])};
+  okapi::Matrix<3, 5> H;
+  H(0, DiffDriveProcessModel::X) = 1;
+  H(1, DiffDriveProcessModel::Y) = 1;
+  H(2, DiffDriveProcessModel::THETA) = 1;
+  double heading_error = gps_heading_error * M_PI / 180;
+  auto R = okapi::Matrix<3, 3>::diagonal({error * error, error * error, heading_error * heading_error});
+
+  if (ekf.update<3>(innovation, H, R, gated_in_a_row >= GPS_GATE_RECOVER ? 0 : GPS_GATE)) {
+    accepted++;
+    gated_in_a_row = 0;
+    // Move the IMU over to the corrected heading, otherwise the next tick pulls it back
+    heading_offset = to_heading(ekf.getState()[DiffDriveProcessModel::THETA]) - last_gyro;
+  } else {
+    rejected++;
+    gated_in_a_row++;
+  }
+}
@@ -0,0 +1,154 @@
+#include "main.h"
+
+ProfiledDrive::ProfiledDrive(Drive &drive)
+    : drive(drive), task([this] { this->profile_task(); }) {}
+
+void ProfiledDrive::set_constraints(double max_velocity, double max_acceleration, double max_jerk) {
+  limits = {max_velocity, max_acceleration, max_jerk};
+}
+
+void ProfiledDrive::set_feedforward(double kv, double ka, double ks) {
+  ff = {kv, ka, ks};
+}
+
+void ProfiledDrive::set_turn_constraints(double max_velocity, double max_acceleration) {
+  turn_limits = {max_velocity, max_acceleration, 0};
+}
+
+void ProfiledDrive::set_turn_feedforward(double kv, double ka, double ks) {
+  turn_ff = {kv, ka, ks};
+}
+
+void ProfiledDrive::set_drive_profile(double target, bool toggle_heading) {
+  set_drive_profile(target, limits, toggle_heading);
+}
+
+void ProfiledDrive::set_drive_profile(double target, constraints p_limits, bool toggle_heading) {
+  // Heading target is left alone, like set_drive_pid()
+  // Keep ez_auto from driving the motors too
+  drive.set_mode(ez::DISABLE);
+
+  mutex.take();
+  printf("Drive Profile Started... Target Value: %f (%f ticks)\n", target, target * drive.get_tick_per_inch());
+
+  // Same constants set_drive_pid() would use
+  PID::Constants pid_consts = target < 0 ? drive.backward_drivePID.get_constants() : drive.forward_drivePID.get_constants();
+  drive.leftPID.set_constants(pid_consts.kp, pid_consts.ki, pid_consts.kd, pid_consts.start_i);
+  drive.rightPID.set_constants(pid_consts.kp, pid_consts.ki, pid_consts.kd, pid_consts.start_i);
+
+  l_start = drive.left_sensor();
+  r_start = drive.right_sensor();
+  drive.leftPID.set_target(l_start);
+  drive.rightPID.set_target(r_start);
+
+  profile = SCurveProfile(target, p_limits.max_velocity, p_limits.max_acceleration, p_limits.max_jerk);
+  setpoint = SCurveProfile::state();
+  heading_on = toggle_heading;
+  kind = DRIVE_PROFILE;
+  start_time = pros::millis();
+  running = true;
+  mutex.give();
+}
+
+void ProfiledDrive::set_turn_profile(double target) {
+  set_turn_profile(target, turn_limits);
+}
+
+void ProfiledDrive::set_turn_profile(double target, constraints p_limits) {
+  drive.set_mode(ez::DISABLE);
+
+  mutex.take();
+  printf("Turn Profile Started... Target Value: %f\n", target);
+
+  // Same as set_turn_pid(), later drives hold this heading
+  drive.headingPID.set_target(target);
+
+  heading_start = drive.get_gyro();
+  drive.turnPID.set_target(heading_start);
+
+  profile = SCurveProfile(target - heading_start, p_limits.max_velocity, p_limits.max_acceleration);
+  setpoint = SCurveProfile::state();
+  kind = TURN_PROFILE;
+  start_time = pros::millis();
+  running = true;
+  mutex.give();
+}
+
+void ProfiledDrive::wait_drive() {
+  pros::delay(ez::util::DELAY_TIME);
+
+  // Let the profile play out, then settle on the final target
+  while (running && (pros::millis() - start_time) / 1000.0 < profile.duration())
+    pros::delay(ez::util::DELAY_TIME);
+
+  if (kind == TURN_PROFILE) {
+    ez::exit_output turn_exit = ez::RUNNING;
+    while (running && turn_exit == ez::RUNNING) {
+      turn_exit = drive.turnPID.exit_condition(drive.left_motors[0]);
+      pros::delay(ez::util::DELAY_TIME);
+    }
+
+    std::cout << "  Turn: " << ez::exit_to_string(turn_exit) << " Exit.\n";
+    return;
+  }
+
+  ez::exit_output left_exit = ez::RUNNING;
+  ez::exit_output right_exit = ez::RUNNING;
+  while (running && (left_exit == ez::RUNNING || right_exit == ez::RUNNING)) {
+    left_exit = left_exit != ez::RUNNING ? left_exit : drive.leftPID.exit_condition(drive.left_motors[0]);
+    right_exit = right_exit != ez::RUNNING ? right_exit : drive.rightPID.exit_condition(drive.right_motors[0]);
+    pros::delay(ez::util::DELAY_TIME);
+  }
+
+  std::cout << "  Left: " << ez::exit_to_string(left_exit) << " Exit.   Right: " << ez::exit_to_string(right_exit) << " Exit.\n";
+}
+
+void ProfiledDrive::profile_task() {
+  while (true) {
+    // Another set_*_pid() took over, or autonomous ended
+    if (running && (drive.get_mode() != ez::DISABLE || !pros::competition::is_autonomous())) running = false;
+
+    if (running) {
+      mutex.take();
+      setpoint = profile.sample((pros::millis() - start_time) / 1000.0);
+      if (kind == TURN_PROFILE)
+        turn_step();
+      else
+        drive_step();
+      mutex.give();
+    }
+
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+
+namespace {
+double feedforward_output(const ProfiledDrive::feedforward &ff, const SCurveProfile::state &setpoint) {
+  double out = ff.kv * setpoint.velocity + ff.ka * setpoint.acceleration;
+  if (setpoint.velocity != 0) out += setpoint.velocity > 0 ? ff.ks : -ff.ks;
+  return out;
+}
+}  // namespace
+
+void ProfiledDrive::drive_step() {
+  double tick_per_inch = drive.get_tick_per_inch();
+  drive.leftPID.set_target(l_start + setpoint.position * tick_per_inch);
+  drive.rightPID.set_target(r_start + setpoint.position * tick_per_inch);
+
+  double ff_out = feedforward_output(ff, setpoint);
+  double l_out = ff_out + drive.leftPID.compute(drive.left_sensor());
+  double r_out = ff_out + drive.rightPID.compute(drive.right_sensor());
+  double gyro_out = heading_on ? drive.headingPID.compute(drive.get_gyro()) : 0;
+
+  l_out = ez::util::clip_num(l_out + gyro_out, 127, -127);
+  r_out = ez::util::clip_num(r_out - gyro_out, 127, -127);
+  drive.set_tank(l_out, r_out);
+}
+
+void ProfiledDrive::turn_step() {
+  drive.turnPID.set_target(heading_start + setpoint.position);
+
+  double out = feedforward_output(turn_ff, setpoint) + drive.turnPID.compute(drive.get_gyro());
+  out = ez::util::clip_num(out, 127, -127);
+  drive.set_tank(out, -out);
+}
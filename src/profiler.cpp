@@ -0,0 +1,136 @@
+#include "main.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace profiler {
+namespace {
+task_stats tasks[PROFILER_MAX_TASKS];
+std::atomic<int> count{0};                     // Slots handed out, some may still be filling in
+std::atomic<bool> ready[PROFILER_MAX_TASKS];  // Set once a slot's fields are written
+
+int bin_for(std::uint32_t us) {
+  int bin = us == 0 ? 0 : 32 - __builtin_clz(us);
+  return bin < PROFILER_BINS ? bin : PROFILER_BINS - 1;
+}
+
+bool valid(int id) { return id >= 0 && id < PROFILER_MAX_TASKS && ready[id].load(std::memory_order_acquire); }
+}  // namespace
+
+int add_task(const char *name, std::uint32_t budget_us, std::uint32_t period_ms) {
+  int id = count.fetch_add(1);
+  if (id >= PROFILER_MAX_TASKS) {
+    count.store(PROFILER_MAX_TASKS);
+    printf("profiler: no slot left for %s\n", name);
+    return -1;
+  }
+  tasks[id].name = name;
+  tasks[id].budget_us = budget_us;
+  tasks[id].period_ms = period_ms;
+  ready[id].store(true, std::memory_order_release);
+  return id;
+}
+
+void loop_begin(int id) {
+  if (!valid(id)) return;
+  task_stats &t = tasks[id];
+  t.prev_start = t.loop_start;
+  t.loop_start = pros::micros();
+
+  if (t.period_ms != 0 && t.prev_start != 0) {
+    std::uint64_t gap = t.loop_start - t.prev_start;
+    std::uint64_t period = t.period_ms * 1000ULL;
+    if (gap > period && gap - period > t.max_late_us)
+      t.max_late_us = gap - period;
+  }
+}
+
+void loop_end(int id) {
+  if (!valid(id)) return;
+  task_stats &t = tasks[id];
+  std::uint32_t us = pros::micros() - t.loop_start;
+
+  t.loops++;
+  t.total_us += us;
+  t.bins[bin_for(us)]++;
+  if (us > t.max_us) t.max_us = us;
+  if (t.budget_us != 0 && us > t.budget_us) t.over_budget++;
+}
+
+pros::Task create_task(void (*loop_body)(), const char *name, std::uint32_t budget_us, std::uint32_t period_ms, std::uint32_t prio) {
+  int id = add_task(name, budget_us, period_ms);
+  return pros::Task(
+      [=]() {
+        std::uint32_t now = pros::millis();
+        while (true) {
+          loop_begin(id);
+          loop_body();
+          loop_end(id);
+          pros::Task::delay_until(&now, period_ms);
+        }
+      },
+      prio, TASK_STACK_DEPTH_DEFAULT, name);
+}
+
+int task_count() { return std::min(count.load(), PROFILER_MAX_TASKS); }
+
+const task_stats *get_stats(int id) { return valid(id) ? &tasks[id] : nullptr; }
+
+void reset() {
+  for (int i = 0; i < task_count(); i++) {
+    if (!valid(i)) continue;
+    task_stats &t = tasks[i];
+    t.loops = 0;
+    t.over_budget = 0;
+    t.max_us = 0;
+    t.total_us = 0;
+    t.max_late_us = 0;
+    t.prev_start = 0;
+    for (int j = 0; j < PROFILER_BINS; j++) t.bins[j] = 0;
+  }
+}
+
+void print() {
+  printf("\n%-14s %8s %7s %7s %7s %7s\n", "task", "loops", "avg us", "max us", "late us", "over");
+  for (int i = 0; i < task_count(); i++) {
+    if (!valid(i)) continue;
+    const task_stats &t = tasks[i];
+    std::uint32_t avg = t.loops == 0 ? 0 : t.total_us / t.loops;
+    printf("%-14s %8lu %7lu %7lu %7lu %7lu%s\n", t.name, (unsigned long)t.loops, (unsigned long)avg,
+           (unsigned long)t.max_us, (unsigned long)t.max_late_us, (unsigned long)t.over_budget,
+           t.over_budget != 0 ? "  OVER BUDGET" : "");
+
+    // Histogram, only the bins that were hit
+    printf("  ");
+    for (int j = 0; j < PROFILER_BINS; j++) {
+      if (t.bins[j] == 0) continue;
+      if (j == PROFILER_BINS - 1)
+        printf(">=%luus:%lu ", 1UL << (j - 1), (unsigned long)t.bins[j]);
+      else
+        printf("<%luus:%lu ", 1UL << j, (unsigned long)t.bins[j]);
+    }
+    printf("\n");
+  }
+}
+
+void print_to_screen(int line) {
+  for (int i = 0; i < task_count() && line + i < 8; i++) {
+    if (!valid(i)) continue;
+    const task_stats &t = tasks[i];
+    std::uint32_t avg = t.loops == 0 ? 0 : t.total_us / t.loops;
+    pros::lcd::print(line + i, "%s%.10s avg %lu max %lu", t.over_budget != 0 ? "!" : "", t.name,
+                     (unsigned long)avg, (unsigned long)t.max_us);
+  }
+}
+
+void start_report_task(std::uint32_t interval_ms) {
+  pros::Task(
+      [=]() {
+        while (true) {
+          pros::delay(interval_ms);
+          print();
+        }
+      },
+      TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "Profiler Report");
+}
+}  // namespace profiler
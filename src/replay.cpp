@@ -0,0 +1,191 @@
+#include "main.h"
+
+#include <cstring>
+
+namespace replay {
+namespace {
+struct file_header {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t frame_size;
+};
+
+RingBuffer<frame, REPLAY_BUFFER_SIZE> buffer;
+std::atomic_bool recording{false};
+// The buffer has one producer and one consumer, so a new recording can't start until the last
+// one's tasks are done with it.  The writer finishes last.
+std::atomic_bool recorder_running{false};
+std::atomic_bool writer_running{false};
+
+// Writer's block buffer and the two frames verify() compares, too big for a task stack
+frame block[REPLAY_BUFFER_SIZE / 4];
+frame frames[2];
+
+pid_sample sample(const PID &pid) {
+  return {pid.target, pid.error, pid.prev_error, pid.integral, pid.derivative, pid.output, pid.constants};
+}
+
+bool same(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+// True if the PID computed between the two samples
+bool computed(const pid_sample &before, const pid_sample &after) {
+  return !same(before.error, after.error) || !same(before.prev_error, after.prev_error) ||
+         !same(before.integral, after.integral) || !same(before.derivative, after.derivative) ||
+         !same(before.output, after.output);
+}
+}  // namespace
+
+void start_recorder(Drive &drive, const char *file_name, std::uint32_t period_ms) {
+  if (!ez::util::IS_SD_CARD) {
+    printf("replay: no SD card, recorder not started\n");
+    return;
+  }
+  if (writer_running.exchange(true)) {
+    if (!recording.load()) printf("replay: the last recording is still being written, recorder not started\n");
+    return;
+  }
+  recorder_running.store(true);
+  recording.store(true);
+
+  pros::Task(
+      [&drive, period_ms]() {
+        pros::Controller controller(pros::E_CONTROLLER_MASTER);
+        std::uint32_t now = pros::millis();
+        while (recording.load()) {
+          // A ready drive task was cut off partway through its tick, let it finish so the PIDs
+          // aren't caught between computes.  Nothing at its priority can interrupt the sampling.
+          for (int tries = 0; tries < 3 && drive.ez_auto.get_state() == pros::E_TASK_STATE_READY; tries++)
+            pros::delay(1);
+
+          frame f;
+          f.time_us = pros::micros();
+          f.mode = drive.get_mode();
+          f.left_sensor = drive.left_sensor();
+          f.right_sensor = drive.right_sensor();
+          f.left_velocity = drive.left_velocity();
+          f.right_velocity = drive.right_velocity();
+          f.axes[0] = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_X);
+          f.axes[1] = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+          f.axes[2] = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
+          f.axes[3] = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+          f.left_mA = drive.left_mA();
+          f.right_mA = drive.right_mA();
+          f.gyro = drive.get_gyro();
+          f.pids[LEFT] = sample(drive.leftPID);
+          f.pids[RIGHT] = sample(drive.rightPID);
+          f.pids[HEADING] = sample(drive.headingPID);
+          f.pids[TURN] = sample(drive.turnPID);
+          f.pids[SWING] = sample(drive.swingPID);
+          buffer.push(f);
+          pros::Task::delay_until(&now, period_ms);
+        }
+        recorder_running.store(false);
+      },
+      TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Replay Recorder");
+
+  pros::Task(
+      [file_name]() {
+        FILE *file = fopen(file_name, "wb");
+        if (file == nullptr) {
+          printf("replay: could not open %s\n", file_name);
+          recording.store(false);
+        } else {
+          file_header header = {{'E', 'Z', 'R', 'P'}, REPLAY_VERSION, sizeof(frame)};
+          fwrite(&header, sizeof(header), 1, file);
+        }
+
+        // Drains until the recorder has pushed its last frame, so nothing is left for the next
+        // recording.  Without a file the frames are thrown away.
+        while (true) {
+          bool stop = !recorder_running.load();
+          std::size_t n;
+          while ((n = buffer.pop(block, REPLAY_BUFFER_SIZE / 4)) != 0)
+            if (file != nullptr) fwrite(block, sizeof(frame), n, file);
+          if (stop) break;
+          if (file != nullptr) fflush(file);
+          pros::delay(50);
+        }
+        if (file != nullptr) fclose(file);
+        writer_running.store(false);
+      },
+      TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "Replay Writer");
+}
+
+void stop_recorder() { recording.store(false); }
+
+std::uint32_t dropped() { return buffer.dropped(); }
+
+result verify(const char *file_name, bool print) {
+  result r;
+  FILE *file = fopen(file_name, "rb");
+  if (file == nullptr) {
+    if (print) printf("replay: could not open %s\n", file_name);
+    return r;
+  }
+
+  file_header header;
+  if (fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, "EZRP", 4) != 0 ||
+      header.version != REPLAY_VERSION || header.frame_size != sizeof(frame)) {
+    if (print) printf("replay: %s is not a version %d recording\n", file_name, REPLAY_VERSION);
+    fclose(file);
+    return r;
+  }
+
+  std::uint64_t first_us = 0, last_us = 0;
+  std::uint64_t start = pros::micros();
+  for (; fread(&frames[r.frames % 2], sizeof(frame), 1, file) == 1; r.frames++) {
+    last_us = frames[r.frames % 2].time_us;
+    if (r.frames == 0) {
+      first_us = last_us;
+      continue;
+    }
+    const frame &before = frames[(r.frames + 1) % 2];
+    const frame &after = frames[r.frames % 2];
+
+    for (int i = 0; i < PID_COUNT; i++) {
+      const pid_sample &a = before.pids[i];
+      const pid_sample &b = after.pids[i];
+      if (!computed(a, b)) continue;
+
+      // Work out which state this compute started from
+      double prev_error, integral;
+      if (same(b.derivative, b.error - a.prev_error)) {
+        prev_error = a.prev_error;
+        integral = a.integral;
+      } else if (same(b.derivative, b.error - 0.0)) {
+        prev_error = 0;
+        integral = 0;
+      } else {
+        r.gaps++;
+        continue;
+      }
+
+      // error = target - current, so target = error and current = 0 hands the PID the exact error
+      PID pid;
+      pid.constants = b.constants;
+      pid.prev_error = prev_error;
+      pid.integral = integral;
+      pid.target = b.error;
+      pid.compute(0.0);
+      r.steps++;
+
+      if (!same(pid.output, b.output) || !same(pid.integral, b.integral) || !same(pid.derivative, b.derivative)) {
+        if (r.mismatches++ == 0) r.first_mismatch_us = after.time_us;
+        if (print)
+          printf("replay: pid %d at %llu us, output %.17g recorded %.17g\n", i, (unsigned long long)after.time_us,
+                 pid.output, b.output);
+      }
+    }
+  }
+  r.elapsed_us = pros::micros() - start;
+  r.ok = true;
+  fclose(file);
+
+  if (print) {
+    printf("replay: %lu frames (%llu ms recorded) in %lu us, %lu computes checked, %lu mismatches, %lu gaps\n",
+           (unsigned long)r.frames, (unsigned long long)((last_us - first_us) / 1000), (unsigned long)r.elapsed_us,
+           (unsigned long)r.steps, (unsigned long)r.mismatches, (unsigned long)r.gaps);
+  }
+  return r;
+}
+}  // namespace replay
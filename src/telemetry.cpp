@@ -0,0 +1,101 @@
+#include "main.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace telemetry {
+namespace {
+Channel channels[TELEMETRY_MAX_CHANNELS];
+std::atomic<int> count{0};                         // Slots handed out, some may still be filling in
+std::atomic<bool> ready[TELEMETRY_MAX_CHANNELS];  // Set once a slot's name and id are written
+
+// Records are written in blocks this big so the SD card sees few, large writes
+const int BLOCK_SIZE = 64;
+record block[BLOCK_SIZE];
+
+int channel_count() { return std::min(count.load(), TELEMETRY_MAX_CHANNELS); }
+
+void write_name(FILE *file, const Channel &channel) {
+  record r = {};
+  r.time_ms = pros::millis();
+  r.channel = channel.id;
+  r.tag = TELEMETRY_TAG_NAME;
+  std::strncpy(reinterpret_cast<char *>(r.values), channel.name, sizeof(r.values) - 1);
+  fwrite(&r, sizeof(r), 1, file);
+}
+}  // namespace
+
+bool Channel::log(std::uint16_t tag, std::initializer_list<float> values) {
+  record r;
+  r.time_ms = pros::millis();
+  r.channel = id;
+  r.tag = tag;
+  r.count = 0;
+  for (float v : values) {
+    if (r.count == TELEMETRY_VALUES) break;
+    r.values[r.count++] = v;
+  }
+  for (int i = r.count; i < TELEMETRY_VALUES; i++) r.values[i] = 0;
+  return buffer.push(r);
+}
+
+bool Channel::log_pid(std::uint16_t tag, const PID &pid) {
+  return log(tag, {(float)pid.target, (float)pid.cur, (float)pid.error, (float)pid.output, (float)pid.integral, (float)pid.derivative});
+}
+
+Channel *add_channel(const char *name) {
+  int i = count.fetch_add(1);
+  if (i >= TELEMETRY_MAX_CHANNELS) {
+    count.store(TELEMETRY_MAX_CHANNELS);
+    printf("telemetry: no channel left for %s\n", name);
+    return nullptr;
+  }
+  channels[i].name = name;
+  channels[i].id = i;
+  ready[i].store(true, std::memory_order_release);
+  return &channels[i];
+}
+
+void start_writer(const char *file_name, std::uint32_t interval_ms) {
+  if (!ez::util::IS_SD_CARD) {
+    printf("telemetry: no SD card, writer not started\n");
+    return;
+  }
+
+  pros::Task(
+      [=]() {
+        FILE *file = fopen(file_name, "ab");
+        if (file == nullptr) {
+          printf("telemetry: could not open %s\n", file_name);
+          return;
+        }
+        // Channels get their name record the first time the writer sees them, so channels added
+        // after the writer started are named too
+        bool named[TELEMETRY_MAX_CHANNELS] = {};
+
+        std::uint32_t now = pros::millis();
+        while (true) {
+          for (int i = 0; i < channel_count(); i++) {
+            if (!ready[i].load(std::memory_order_acquire)) continue;
+            if (!named[i]) {
+              write_name(file, channels[i]);
+              named[i] = true;
+            }
+            std::size_t n;
+            while ((n = channels[i].buffer.pop(block, BLOCK_SIZE)) != 0)
+              fwrite(block, sizeof(record), n, file);
+          }
+          fflush(file);
+          pros::Task::delay_until(&now, interval_ms);
+        }
+      },
+      TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "Telemetry Writer");
+}
+
+std::uint32_t dropped() {
+  std::uint32_t total = 0;
+  for (int i = 0; i < channel_count(); i++)
+    if (ready[i].load(std::memory_order_acquire)) total += channels[i].buffer.dropped();
+  return total;
+}
+}  // namespace telemetry
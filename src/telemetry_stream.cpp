@@ -0,0 +1,168 @@
+#include "main.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "pros/apix.h"
+
+namespace telemetry {
+namespace {
+// A slot is handed out by count and stays null until its stream is filled in
+std::atomic<Stream *> streams[TELEMETRY_MAX_STREAMS];
+std::atomic<int> count{0};
+
+// Schema frames are built by the writer task only, so one buffer is enough
+const std::size_t NAME_LENGTH = 24;
+const std::size_t SCHEMA_SIZE = 4 + NAME_LENGTH + 1 + TELEMETRY_STREAM_FIELDS * (NAME_LENGTH + 1 + 4);
+std::uint8_t schema_raw[SCHEMA_SIZE];
+std::uint8_t schema_frame[codec::cobs_max_size(SCHEMA_SIZE) + 2];
+Stream::frame block[TELEMETRY_STREAM_SIZE];
+
+std::size_t put_string(std::uint8_t *out, const char *text) {
+  std::size_t len = strnlen(text, NAME_LENGTH);
+  std::memcpy(out, text, len);
+  out[len] = 0;
+  return len + 1;
+}
+
+// Wraps a raw frame with its crc, COBS and a delimiter on both sides.  The leading delimiter ends
+// any printf text that went out before the frame, so the text can't corrupt it.
+std::size_t finish_frame(std::uint8_t *raw, std::size_t len, std::uint8_t *out) {
+  raw[len] = codec::crc8(raw, len);
+  out[0] = 0;
+  std::size_t n = codec::cobs_encode(raw, len + 1, out + 1) + 1;
+  out[n] = 0;
+  return n + 1;
+}
+
+void write_schema(const Stream &stream) {
+  std::size_t n = 0;
+  schema_raw[n++] = codec::FRAME_SCHEMA;
+  schema_raw[n++] = stream.id;
+  schema_raw[n++] = stream.count;
+  n += put_string(schema_raw + n, stream.name);
+  for (int i = 0; i < stream.count; i++) {
+    n += put_string(schema_raw + n, stream.fields[i].name);
+    std::memcpy(schema_raw + n, &stream.fields[i].scale, 4);
+    n += 4;
+  }
+  fwrite(schema_frame, 1, finish_frame(schema_raw, n, schema_frame), stdout);
+}
+}  // namespace
+
+Stream::Stream(const char *name, std::initializer_list<field> fields) : name(name) {
+  for (const field &f : fields) {
+    if (count == TELEMETRY_STREAM_FIELDS) break;
+    this->fields[count++] = f;
+  }
+
+  int i = telemetry::count.fetch_add(1);
+  if (i >= TELEMETRY_MAX_STREAMS) {
+    telemetry::count.store(TELEMETRY_MAX_STREAMS);
+    printf("telemetry: no stream left for %s\n", name);
+    return;
+  }
+  id = i;
+  streams[i].store(this, std::memory_order_release);
+}
+
+bool Stream::send(std::initializer_list<double> values) {
+  if (id == TELEMETRY_INVALID_STREAM) return false;
+
+  bool key = since_key >= TELEMETRY_KEY_INTERVAL;
+  std::uint32_t now = pros::millis();
+
+  std::uint8_t raw[STREAM_FRAME_SIZE];
+  std::size_t n = 0;
+  raw[n++] = key ? codec::FRAME_KEY : codec::FRAME_DELTA;
+  raw[n++] = id;
+  raw[n++] = sequence;
+  n += codec::put_varint(raw + n, key ? now : now - last_time);
+
+  const double *value = values.begin();
+  for (int i = 0; i < count; i++) {
+    double v = value != values.end() ? *value++ : 0;
+    std::int32_t q = std::lround(v / fields[i].scale);
+    n += codec::put_varint(raw + n, codec::zigzag(key ? q : q - last[i]));
+    last[i] = q;
+  }
+
+  frame f;
+  f.len = finish_frame(raw, n, f.bytes);
+  if (!frames.push(f)) {
+    // The host will see the sequence jump, start over from a key frame
+    since_key = TELEMETRY_KEY_INTERVAL;
+    sequence++;
+    return false;
+  }
+
+  last_time = now;
+  sequence++;
+  since_key = key ? 1 : since_key + 1;
+  return true;
+}
+
+void start_serial_writer(std::uint32_t interval_ms) {
+  pros::Task(
+      [=]() {
+        pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+
+        std::uint32_t now = pros::millis();
+        std::uint32_t last_schema = 0;
+        while (true) {
+          // Resend schemas every second so a host that connects late can decode
+          bool schemas = last_schema == 0 || now - last_schema >= 1000;
+          if (schemas) last_schema = now;
+
+          int streams_used = std::min(count.load(), TELEMETRY_MAX_STREAMS);
+          for (int i = 0; i < streams_used; i++) {
+            Stream *stream = streams[i].load(std::memory_order_acquire);
+            if (stream == nullptr) continue;
+            if (schemas) write_schema(*stream);
+            std::size_t n = stream->frames.pop(block, TELEMETRY_STREAM_SIZE);
+            for (std::size_t j = 0; j < n; j++) fwrite(block[j].bytes, 1, block[j].len, stdout);
+          }
+          fflush(stdout);
+          pros::Task::delay_until(&now, interval_ms);
+        }
+      },
+      TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Telemetry Serial");
+}
+
+void start_drive_stream(Drive &drive, std::uint32_t period_ms) {
+  static Stream stream("drive", {
+                                    {"left_target", 0.01},
+                                    {"left_error", 0.01},
+                                    {"left_output", 0.01},
+                                    {"right_target", 0.01},
+                                    {"right_error", 0.01},
+                                    {"right_output", 0.01},
+                                    {"heading_target", 0.01},
+                                    {"heading_error", 0.01},
+                                    {"heading_output", 0.01},
+                                    {"turn_target", 0.01},
+                                    {"turn_error", 0.01},
+                                    {"turn_output", 0.01},
+                                    {"swing_target", 0.01},
+                                    {"swing_error", 0.01},
+                                    {"swing_output", 0.01},
+                                    {"imu_heading", 0.01},
+                                });
+
+  pros::Task(
+      [&drive, period_ms]() {
+        std::uint32_t now = pros::millis();
+        while (true) {
+          stream.send({drive.leftPID.target, drive.leftPID.error, drive.leftPID.output,
+                       drive.rightPID.target, drive.rightPID.error, drive.rightPID.output,
+                       drive.headingPID.target, drive.headingPID.error, drive.headingPID.output,
+                       drive.turnPID.target, drive.turnPID.error, drive.turnPID.output,
+                       drive.swingPID.target, drive.swingPID.error, drive.swingPID.output,
+                       drive.get_gyro()});
+          pros::Task::delay_until(&now, period_ms);
+        }
+      },
+      TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Drive Stream");
+}
+}  // namespace telemetry
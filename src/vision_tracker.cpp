@@ -0,0 +1,139 @@
+#include "main.h"
+
+using okapi::Matrix;
+using okapi::Vector;
+
+namespace {
+const double PIXEL_VARIANCE = 2.0 * 2.0;
+const double ACCEL_VARIANCE = 2000.0 * 2000.0;  // Pixels per second^2, objects jump around when the robot turns
+const double START_VELOCITY_VARIANCE = 400.0 * 400.0;
+const double ASSOCIATION_GATE = 40;  // Farthest a detection can be from a track's prediction, pixels
+const int MAX_MISSES = 5;            // Frames a track survives without a detection
+}  // namespace
+
+VisionTracker::VisionTracker(std::uint8_t port) : sensor(port) {}
+
+void VisionTracker::add_signature(std::uint32_t signature) {
+  if (signature_count >= VISION_MAX_SIGNATURES) return;
+  signatures[signature_count++] = signature;
+}
+
+bool VisionTracker::is_tracked(std::uint32_t signature) const {
+  for (int i = 0; i < signature_count; i++)
+    if (signatures[i] == signature) return true;
+  return false;
+}
+
+bool VisionTracker::find(std::uint32_t signature, track &out) const {
+  tracks current = get_tracks();
+  int best = -1;
+  for (int i = 0; i < current.count; i++) {
+    const track &t = current.list[i];
+    if (t.signature == signature && (best < 0 || t.width * t.height > current.list[best].width * current.list[best].height))
+      best = i;
+  }
+  if (best < 0) return false;
+  out = current.list[best];
+  return true;
+}
+
+void VisionTracker::start(std::uint32_t period_ms) {
+  pros::Task(
+      [this, period_ms] {
+        pros::vision_object_s_t objects[VISION_MAX_OBJECTS];
+        std::uint32_t now = pros::millis();
+        std::uint32_t last = now;
+        while (true) {
+          // Every signature in one read, sorted by size
+          std::int32_t count = sensor.read_by_size(0, VISION_MAX_OBJECTS, objects);
+          if (count == PROS_ERR) count = 0;
+
+          std::uint32_t time = pros::millis();
+          update(objects, count, (time - last) / 1000.0, time);
+          last = time;
+          pros::Task::delay_until(&now, period_ms);
+        }
+      },
+      TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "Vision Tracker");
+}
+
+void VisionTracker::update(const pros::vision_object_s_t *objects, int count, double dt, std::uint32_t now) {
+  // Move every track to where it should be now
+  Matrix<4, 4> F = Matrix<4, 4>::identity();
+  F(0, 2) = dt;
+  F(1, 3) = dt;
+  Matrix<4, 2> G;
+  G(0, 0) = G(1, 1) = dt * dt / 2;
+  G(2, 0) = G(3, 1) = dt;
+  Matrix<4, 4> Q = G * G.transpose() * ACCEL_VARIANCE;
+  for (int i = 0; i < active_count; i++) {
+    okapi::ExtendedKalmanFilter<4> &filter = active[i].filter;
+    filter.predict(F * filter.getState(), F, Q);
+  }
+
+  // Pair detections and tracks, closest pairs first
+  bool used[VISION_MAX_OBJECTS] = {false};
+  bool matched[VISION_MAX_TRACKS] = {false};
+  Matrix<2, 4> H = {1, 0, 0, 0,
+                    0, 1, 0, 0};
+  Matrix<2, 2> R = Matrix<2, 2>::diagonal({PIXEL_VARIANCE, PIXEL_VARIANCE});
+  while (true) {
+    int best_object = -1, best_track = -1;
+    double best_distance = ASSOCIATION_GATE;
+    for (int o = 0; o < count; o++) {
+      if (used[o] || !is_tracked(objects[o].signature)) continue;
+      for (int t = 0; t < active_count; t++) {
+        if (matched[t] || active[t].info.signature != objects[o].signature) continue;
+        const Vector<4> &x = active[t].filter.getState();
+        double distance = std::hypot(objects[o].x_middle_coord - x[0], objects[o].y_middle_coord - x[1]);
+        if (distance < best_distance) {
+          best_distance = distance;
+          best_object = o;
+          best_track = t;
+        }
+      }
+    }
+    if (best_object < 0) break;
+
+    const pros::vision_object_s_t &object = objects[best_object];
+    filter_track &match = active[best_track];
+    match.filter.updateLinear<2>({(double)object.x_middle_coord, (double)object.y_middle_coord}, H, R);
+    match.info.width = object.width;
+    match.info.height = object.height;
+    match.info.last_seen = now;
+    match.misses = 0;
+    used[best_object] = true;
+    matched[best_track] = true;
+  }
+
+  // Drop tracks that have not been seen in a while, then start tracks for new objects
+  int kept = 0;
+  for (int t = 0; t < active_count; t++) {
+    if (!matched[t] && ++active[t].misses > MAX_MISSES) continue;
+    active[kept++] = active[t];
+  }
+  active_count = kept;
+
+  for (int o = 0; o < count && active_count < VISION_MAX_TRACKS; o++) {
+    if (used[o] || !is_tracked(objects[o].signature)) continue;
+    filter_track &created = active[active_count++];
+    created.info = {next_id++, objects[o].signature, 0, 0, 0, 0, objects[o].width, objects[o].height, now};
+    created.filter.reset({(double)objects[o].x_middle_coord, (double)objects[o].y_middle_coord, 0, 0},
+                         Matrix<4, 4>::diagonal({PIXEL_VARIANCE, PIXEL_VARIANCE, START_VELOCITY_VARIANCE, START_VELOCITY_VARIANCE}));
+    created.misses = 0;
+  }
+
+  tracks snapshot;
+  snapshot.time = now;
+  snapshot.count = active_count;
+  for (int t = 0; t < active_count; t++) {
+    const Vector<4> &x = active[t].filter.getState();
+    track &out = snapshot.list[t];
+    out = active[t].info;
+    out.x = x[0];
+    out.y = x[1];
+    out.x_velocity = x[2];
+    out.y_velocity = x[3];
+  }
+  published.write(snapshot);
+}
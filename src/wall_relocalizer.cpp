@@ -0,0 +1,112 @@
+#include "main.h"
+
+namespace {
+const double MM_TO_INCH = 1 / 25.4;
+const int CONFIDENT_RANGE_MM = 200;  // The sensor only reports confidence past this
+const double MIN_BASELINE = 2;       // Closest two sensors can be across the beam to measure heading
+
+double wrap_180(double degrees) { return degrees - 360 * std::floor((degrees + 180) / 360); }
+double to_rad(double degrees) { return degrees * M_PI / 180; }
+}  // namespace
+
+WallRelocalizer::WallRelocalizer(PoseEstimator &estimator, double field_half_width)
+    : estimator(estimator), half_width(field_half_width) {}
+
+void WallRelocalizer::add_sensor(pros::Distance &sensor, double forward, double right, double facing) {
+  if (mount_count >= RELOCALIZER_MAX_SENSORS) {
+    printf("WallRelocalizer: only %i sensors can be added\n", RELOCALIZER_MAX_SENSORS);
+    return;
+  }
+  double angle = to_rad(facing);
+  mounts[mount_count++] = {&sensor, right * std::sin(angle) + forward * std::cos(angle),
+                           right * std::cos(angle) - forward * std::sin(angle), facing};
+}
+
+PoseEstimator::pose_fix WallRelocalizer::relocalize() {
+  PoseEstimator::pose_fix fix;
+  if (std::fabs(estimator.get_velocity()) > max_speed) return fix;
+  PoseEstimator::pose pose = estimator.get_pose();
+
+  // Every reading that hits a wall square enough
+  struct hit {
+    int wall;       // 0 +y, 1 +x, 2 -y, 3 -x
+    double along;   // Center of the robot to the wall, along the beam
+    double lateral;
+    double facing;
+    double angle;   // Beam minus the wall's normal, degrees clockwise
+  };
+  hit hits[RELOCALIZER_MAX_SENSORS];
+  int hit_count = 0;
+
+  for (int i = 0; i < mount_count; i++) {
+    const mount &m = mounts[i];
+    std::int32_t mm = m.sensor->get();
+    if (mm == PROS_ERR || mm <= 0 || mm * MM_TO_INCH > max_range) continue;
+    if (mm > CONFIDENT_RANGE_MM && m.sensor->get_confidence() < min_confidence) continue;
+
+    double beam = pose.heading + m.facing;
+    int wall = std::lround(beam / 90);
+    double angle = wrap_180(beam - wall * 90);
+    if (std::fabs(angle) > max_angle) continue;
+    hits[hit_count++] = {((wall % 4) + 4) % 4, m.along + mm * MM_TO_INCH, m.lateral, m.facing, angle};
+  }
+
+  for (int wall = 0; wall < 4; wall++) {
+    hit *on_wall[RELOCALIZER_MAX_SENSORS];
+    int count = 0;
+    for (int i = 0; i < hit_count; i++)
+      if (hits[i].wall == wall) on_wall[count++] = &hits[i];
+    if (count == 0) continue;
+
+    // Two parallel sensors on the same wall measure the angle to it
+    double angle = on_wall[0]->angle;
+    for (int i = 0; i < count && !fix.has_heading; i++) {
+      for (int j = i + 1; j < count; j++) {
+        double baseline = on_wall[i]->lateral - on_wall[j]->lateral;
+        if (on_wall[i]->facing != on_wall[j]->facing || std::fabs(baseline) < MIN_BASELINE) continue;
+
+        double measured = std::atan((on_wall[i]->along - on_wall[j]->along) / baseline) * 180 / M_PI;
+        double heading = wall * 90 + measured - on_wall[i]->facing;
+        if (std::fabs(wrap_180(heading - pose.heading)) > max_angle) continue;
+
+        angle = measured;
+        fix.has_heading = true;
+        fix.heading = wrap_180(heading);
+        if (fix.heading < 0) fix.heading += 360;
+        break;
+      }
+    }
+
+    // Distance from the center of the field to the robot, along the wall's normal
+    double normal = 0;
+    for (int i = 0; i < count; i++)
+      normal += half_width - on_wall[i]->along * std::cos(to_rad(angle)) + on_wall[i]->lateral * std::sin(to_rad(angle));
+    normal /= count;
+
+    bool is_x = wall % 2 == 1;
+    double position = wall >= 2 ? -normal : normal;
+    if (std::fabs(position - (is_x ? pose.x : pose.y)) > max_correction) continue;
+    if (is_x) {
+      fix.has_x = true;
+      fix.x = position;
+    } else {
+      fix.has_y = true;
+      fix.y = position;
+    }
+  }
+
+  if (fix.has_x || fix.has_y || fix.has_heading) estimator.correct(fix);
+  return fix;
+}
+
+void WallRelocalizer::start(std::uint32_t period_ms) {
+  pros::Task(
+      [this, period_ms] {
+        std::uint32_t now = pros::millis();
+        while (true) {
+          if (pros::competition::is_autonomous()) relocalize();
+          pros::Task::delay_until(&now, period_ms);
+        }
+      },
+      TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "Wall Relocalizer");
+}
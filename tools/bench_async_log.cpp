@@ -0,0 +1,127 @@
+// Host check for okapi::AsyncLogFile, the log file that keeps okapi::Logger from blocking on I/O.
+//
+// Build:  g++ -std=gnu++17 -O2 -DTHREADS_STD -Iinclude tools/bench_async_log.cpp -o bench_async_log -lpthread
+// Use:    bench_async_log [lines]
+//
+// Prints the average time of a debug log call for a Logger on a plain file and on an
+// AsyncLogFile.  Then four threads log through one AsyncLogFile at once, and the check reads the
+// file back: every line must be whole, and the lines written plus the lines dropped must add up to
+// the lines logged.  Exits with 1 if they don't.  The okapilib parts Logger needs from outside the
+// headers are stubbed below, just enough to run.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "okapi/api/util/asyncLogFile.hpp"
+#include "okapi/api/util/logging.hpp"
+
+using namespace okapi;
+
+// Stand-ins for okapilib, which the host build doesn't link
+namespace okapi {
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE *ifile, const LogLevel &ilevel) noexcept
+  : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {}
+Logger::~Logger() { close(); }
+
+AbstractTimer::AbstractTimer(QTime ifirstCalled)
+  : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0_ms), repeatMark(-1_ms) {}
+AbstractTimer::~AbstractTimer() = default;
+QTime AbstractTimer::getDt() { return 0_ms; }
+QTime AbstractTimer::readDt() const { return 0_ms; }
+QTime AbstractTimer::getStartingTime() const { return firstCalled; }
+QTime AbstractTimer::getDtFromStart() const { return 0_ms; }
+void AbstractTimer::placeMark() {}
+QTime AbstractTimer::clearMark() { return 0_ms; }
+void AbstractTimer::placeHardMark() {}
+QTime AbstractTimer::clearHardMark() { return 0_ms; }
+QTime AbstractTimer::getDtFromMark() const { return 0_ms; }
+QTime AbstractTimer::getDtFromHardMark() const { return 0_ms; }
+bool AbstractTimer::repeat(QTime) { return false; }
+bool AbstractTimer::repeat(QFrequency) { return false; }
+}  // namespace okapi
+
+namespace {
+const char *SYNC_FILE = "bench_async_log_sync.txt";
+const char *ASYNC_FILE = "bench_async_log_async.txt";
+const int THREADS = 4;
+
+struct FixedTimer : AbstractTimer {
+  FixedTimer() : AbstractTimer(0_ms) {}
+  QTime millis() const override { return 5_ms; }
+};
+
+std::shared_ptr<Logger> make_logger(FILE *file) {
+  return std::make_shared<Logger>(std::make_unique<FixedTimer>(), file, Logger::LogLevel::debug);
+}
+
+double ns_per_line(Logger &logger, int lines) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lines; i++) logger.debug([=] { return "left 123.45 right 67.89 step " + std::to_string(i); });
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lines;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int lines = argc > 1 ? std::atoi(argv[1]) : 2000;
+  if (lines <= 0) {
+    fprintf(stderr, "lines must be positive\n");
+    return 1;
+  }
+
+  {
+    auto sync = make_logger(fopen(SYNC_FILE, "w"));
+    auto async = make_logger(AsyncLogFile::open(ASYNC_FILE));
+    printf("Logger on a plain file     %8.1f ns/line\n", ns_per_line(*sync, lines));
+    printf("Logger on an AsyncLogFile  %8.1f ns/line\n", ns_per_line(*async, lines));
+  }
+  std::uint32_t dropped_before = AsyncLogFile::getDroppedCount();
+
+  std::remove(ASYNC_FILE);
+  {
+    auto logger = make_logger(AsyncLogFile::open(ASYNC_FILE, 2_ms));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < lines; i++) {
+          logger->debug([=] { return "thread " + std::to_string(t) + " line " + std::to_string(i); });
+          if (i % 50 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+  }  // Closing the file writes out the rest
+  std::uint32_t dropped = AsyncLogFile::getDroppedCount() - dropped_before;
+
+  FILE *file = fopen(ASYNC_FILE, "r");
+  char line[256];
+  int written = 0, torn = 0;
+  while (file && fgets(line, sizeof(line), file)) {
+    int thread, index;
+    char name[64];
+    if (std::sscanf(line, "5 (%63[^)]) DEBUG: thread %d line %d", name, &thread, &index) != 3 ||
+        line[std::strlen(line) - 1] != '\n')
+      torn++;
+    written++;
+  }
+  if (file) fclose(file);
+  std::remove(SYNC_FILE);
+  std::remove(ASYNC_FILE);
+
+  printf("%d threads logged %d lines: %d written, %u dropped, %d torn\n", THREADS, THREADS * lines, written,
+         dropped, torn);
+  if (torn != 0 || written + static_cast<int>(dropped) != THREADS * lines) {
+    printf("FAIL\n");
+    return 1;
+  }
+  printf("ok\n");
+  return 0;
+}
@@ -0,0 +1,109 @@
+// Host benchmark for okapi::RunningAverageFilter and okapi::BatchAverageFilter against
+// okapi::AverageFilter.
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude tools/bench_average.cpp -o bench_average
+// Use:    bench_average [samples]
+//
+// First checks that RunningAverageFilter stays close to AverageFilter over millions of large
+// readings and that BatchAverageFilter matches RunningAverageFilter exactly.  Then prints the
+// average time per sample of each filter for windows from 5 to 100.  The batch filter runs 6
+// channels, like the drive motors, and its time is per channel.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/batchAverageFilter.hpp"
+#include "okapi/api/filter/runningAverageFilter.hpp"
+
+// Lives in the prebuilt okapilib, which the host build doesn't link
+okapi::Filter::~Filter() = default;
+
+namespace {
+const std::size_t CHANNELS = 6;
+const std::size_t INPUT_SIZE = 4096;  // Readings are replayed from a buffer this size
+
+template <std::size_t n>
+bool check() {
+  okapi::AverageFilter<n> average;
+  okapi::RunningAverageFilter<n> running;
+  okapi::BatchAverageFilter<n, 3> batch;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> reading(-1e6, 1e6);
+  double worst = 0;
+  for (int i = 0; i < 2000000; i++) {
+    double value = reading(rng) + (i % 7) * 1e-3;
+    double expected = average.filter(value);
+    double result = running.filter(value);
+    if (batch.filter({value, value, value})[1] != result) {
+      printf("n=%zu: batch differs from running at reading %d\n", n, i);
+      return false;
+    }
+    worst = std::max(worst, std::fabs(expected - result));
+  }
+  printf("n=%zu: largest difference from AverageFilter %.3g\n", n, worst);
+  return true;
+}
+
+template <typename F>
+double ns_per_sample(const std::vector<double> &input, int samples) {
+  F filter;
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; i++) sum += filter.filter(input[i % INPUT_SIZE]);
+  auto end = std::chrono::steady_clock::now();
+  volatile double sink = sum;  // Keeps the loop from being optimized away
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(end - start).count() / samples;
+}
+
+template <std::size_t n>
+double batch_ns_per_sample(const std::vector<double> &input, int samples) {
+  okapi::BatchAverageFilter<n, CHANNELS> filter;
+  int steps = samples / CHANNELS;
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < steps; i++) sum += filter.filter(&input[(i % INPUT_SIZE) * CHANNELS])[CHANNELS / 2];
+  auto end = std::chrono::steady_clock::now();
+  volatile double sink = sum;
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(end - start).count() / (steps * CHANNELS);
+}
+
+template <std::size_t n>
+void bench(const std::vector<double> &input, int samples) {
+  printf("%5zu %14.1f %21.1f %19.1f\n", n, ns_per_sample<okapi::AverageFilter<n>>(input, samples),
+         ns_per_sample<okapi::RunningAverageFilter<n>>(input, samples), batch_ns_per_sample<n>(input, samples));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int samples = argc > 1 ? std::atoi(argv[1]) : 6000000;
+  if (samples < static_cast<int>(CHANNELS)) {
+    fprintf(stderr, "samples must be at least %zu\n", CHANNELS);
+    return 1;
+  }
+
+  if (!check<5>() || !check<64>()) return 1;
+  printf("\n");
+
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> reading(-600, 600);  // Motor velocities
+  std::vector<double> input(INPUT_SIZE * CHANNELS);
+  for (double &r : input) r = reading(rng);
+
+  printf("%5s %14s %21s %19s\n", "n", "AverageFilter", "RunningAverageFilter", "BatchAverageFilter");
+  printf("%5s %14s %21s %19s\n", "", "ns/sample", "ns/sample", "ns/sample, 6 ch");
+  bench<5>(input, samples);
+  bench<10>(input, samples);
+  bench<20>(input, samples);
+  bench<50>(input, samples);
+  bench<100>(input, samples);
+  return 0;
+}
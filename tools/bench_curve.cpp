@@ -0,0 +1,104 @@
+// Host benchmark for CurveTable against the joystick curve it replaces.
+//
+// Build:  g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/bench_curve.cpp src/curve_table.cpp -o bench_curve
+// Use:    bench_curve [reads]
+//
+// For every curve scale the controller buttons can reach, 0 to 20 in steps of 0.1, rebuilds the
+// tables and checks that left() and right() return exactly the truncated curve for all 256 stick
+// values.  Then prints the average time of one stick read through the curve and through the
+// table.  Exits with 1 if any value differs.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "main.h"
+
+// The drive and the controller live in the prebuilt EZ-Template and libpros, which the host build
+// doesn't link.  The curve is written the same way as EZ-Template 2.1.1's and kept out of line
+// like the library's.  The rest only has to link, the check never drives.
+namespace {
+double left_scale = 0;
+double right_scale = 0;
+
+double curve(double x, double scale) {
+  if (scale != 0)
+    return (powf(2.718, -(scale / 10)) + powf(2.718, (fabs(x) - 127) / 10) * (1 - powf(2.718, -(scale / 10)))) * x;
+  return x;
+}
+}  // namespace
+
+[[gnu::noinline]] double Drive::left_curve_function(double x) { return curve(x, left_scale); }
+[[gnu::noinline]] double Drive::right_curve_function(double x) { return curve(x, right_scale); }
+void Drive::tank() {}
+void Drive::arcade_standard(e_type) {}
+void Drive::arcade_flipped(e_type) {}
+void Drive::reset_drive_sensors_opcontrol() {}
+void Drive::modify_curve_with_controller() {}
+void Drive::joy_thresh_opcontrol(int, int) {}
+pros::Controller::Controller(pros::controller_id_e_t id) : _id(id) {}
+std::int32_t pros::Controller::get_analog(pros::controller_analog_e_t) { return 0; }
+std::int32_t pros::Controller::get_digital(pros::controller_digital_e_t) { return 0; }
+pros::Controller master(pros::E_CONTROLLER_MASTER);
+namespace pros {
+namespace usd {
+std::int32_t is_installed() { return 0; }
+}  // namespace usd
+}  // namespace pros
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// CurveTable only passes the drive to the functions above, so it is never constructed
+alignas(Drive) unsigned char drive_storage[sizeof(Drive)];
+Drive &drive = *reinterpret_cast<Drive *>(drive_storage);
+
+double ns_since(Clock::time_point start, int reads) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / reads;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int reads = argc > 1 ? std::atoi(argv[1]) : 10000000;
+  if (reads <= 0) {
+    fprintf(stderr, "reads must be positive\n");
+    return 1;
+  }
+
+  CurveTable table(drive);
+  int mismatches = 0, scales = 0;
+  for (int tenths = 0; tenths <= 200; tenths++, scales++) {
+    left_scale = tenths / 10.0;
+    right_scale = (200 - tenths) / 10.0;
+    table.rebuild();
+    for (int stick = -128; stick <= 127; stick++) {
+      if (table.left(stick) != (int)drive.left_curve_function(stick) ||
+          table.right(stick) != (int)drive.right_curve_function(stick)) {
+        if (mismatches++ < 5) printf("left scale %.1f, stick %d: table differs from the curve\n", left_scale, stick);
+      }
+    }
+  }
+  printf("%d curve scales, 256 stick values each, %d mismatches\n\n", scales, mismatches);
+
+  // Stick values like a driver's, replayed from a buffer
+  left_scale = right_scale = 2;
+  table.rebuild();
+  std::vector<int> sticks(4096);
+  for (std::size_t i = 0; i < sticks.size(); i++) sticks[i] = (int)std::lround(127 * std::sin(i * 0.01));
+
+  long sum = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < reads; i++) sum += (int)drive.left_curve_function(sticks[i % sticks.size()]);
+  double curve_ns = ns_since(start, reads);
+  start = Clock::now();
+  for (int i = 0; i < reads; i++) sum += table.left(sticks[i % sticks.size()]);
+  double table_ns = ns_since(start, reads);
+  volatile long sink = sum;  // Keeps the loops from being optimized away
+  (void)sink;
+
+  printf("left_curve_function  %6.2f ns/read\n", curve_ns);
+  printf("CurveTable::left     %6.2f ns/read\n", table_ns);
+  return mismatches == 0 ? 0 : 1;
+}
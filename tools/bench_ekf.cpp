@@ -0,0 +1,97 @@
+// Host timing check for okapi::ExtendedKalmanFilter with DiffDriveProcessModel, the filter
+// PoseEstimator runs every 10 ms drive tick.
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude tools/bench_ekf.cpp -o bench_ekf
+// Use:    bench_ekf [ticks]
+//
+// Drives a simulated robot around a circle and times each stage of a tick: predict, the wheel
+// update, the IMU update and a GPS pose update.  Prints the average time of each and how much of
+// the 10 ms tick a full tick takes on this machine.  The brain is a lot slower than a desktop, so
+// scale the result before comparing it against the budget.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "okapi/api/filter/diffDriveProcessModel.hpp"
+
+using okapi::DiffDriveProcessModel;
+using okapi::ExtendedKalmanFilter;
+using okapi::Matrix;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+const double DT = 0.01;
+const double TICK_US = DT * 1e6;
+const double TRACK_WIDTH = 12;
+const double SPEED = 40;          // Inches per second
+const double TURN_RATE = 0.5;     // Radians per second
+const double WHEEL_STD_DEV = 2;
+const double IMU_STD_DEV = 0.005;
+const double GPS_STD_DEV = 0.5;
+
+double elapsed_ns(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int ticks = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  if (ticks <= 0) {
+    fprintf(stderr, "ticks must be positive\n");
+    return 1;
+  }
+
+  DiffDriveProcessModel model(TRACK_WIDTH, 60, 10);
+  ExtendedKalmanFilter<5> ekf;
+  std::mt19937 rng(1);
+  std::normal_distribution<double> noise(0, 1);
+  const Matrix<3, 3> gps_R = Matrix<3, 3>::diagonal({GPS_STD_DEV * GPS_STD_DEV, GPS_STD_DEV * GPS_STD_DEV, 0.01});
+
+  double predict_ns = 0, wheels_ns = 0, imu_ns = 0, gps_ns = 0;
+  int gps_updates = 0;
+  double x = 0, y = 0, theta = 0;
+  for (int i = 0; i < ticks; i++) {
+    x += SPEED * std::cos(theta) * DT;
+    y += SPEED * std::sin(theta) * DT;
+    theta = DiffDriveProcessModel::wrapAngle(theta + TURN_RATE * DT);
+    double left = SPEED - TURN_RATE * TRACK_WIDTH / 2 + WHEEL_STD_DEV * noise(rng);
+    double right = SPEED + TURN_RATE * TRACK_WIDTH / 2 + WHEEL_STD_DEV * noise(rng);
+    double heading = theta + IMU_STD_DEV * noise(rng);
+
+    Clock::time_point start = Clock::now();
+    model.predict(ekf, DT);
+    predict_ns += elapsed_ns(start);
+
+    start = Clock::now();
+    model.updateWheels(ekf, left, right, WHEEL_STD_DEV * WHEEL_STD_DEV);
+    wheels_ns += elapsed_ns(start);
+
+    start = Clock::now();
+    model.updateImu(ekf, heading, TURN_RATE, IMU_STD_DEV * IMU_STD_DEV, 0.01);
+    imu_ns += elapsed_ns(start);
+
+    // The GPS reports about every 20 ms
+    if (i % 2 == 0) {
+      start = Clock::now();
+      model.updatePose(ekf, x + GPS_STD_DEV * noise(rng), y + GPS_STD_DEV * noise(rng), theta, gps_R, 11.3);
+      gps_ns += elapsed_ns(start);
+      gps_updates++;
+    }
+  }
+
+  const auto &state = ekf.getState();
+  double error = std::hypot(state[DiffDriveProcessModel::X] - x, state[DiffDriveProcessModel::Y] - y);
+  double tick_ns = (predict_ns + wheels_ns + imu_ns + gps_ns) / ticks;
+
+  printf("%d ticks, final position error %.3f in\n", ticks, error);
+  printf("predict        %8.1f ns\n", predict_ns / ticks);
+  printf("wheel update   %8.1f ns\n", wheels_ns / ticks);
+  printf("imu update     %8.1f ns\n", imu_ns / ticks);
+  printf("gps update     %8.1f ns\n", gps_ns / gps_updates);
+  printf("full tick      %8.1f ns, %.4f%% of the %.0f us tick\n", tick_ns, tick_ns / 10 / TICK_US,
+         TICK_US);
+  return 0;
+}
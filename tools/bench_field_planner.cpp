@@ -0,0 +1,104 @@
+// Host timing check for FieldPlanner on the Over Under field.
+//
+// Build:  g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/bench_field_planner.cpp src/field_planner.cpp -o bench_field_planner
+// Use:    bench_field_planner [repeats]
+//
+// Times build(), then plans full-field queries with an 18 inch robot that drives over the short
+// barriers.  Prints the average time of each query and checks that every straight segment between
+// its waypoints is clear.  Last it times a query the barriers cut off, which searches every state
+// before giving up.  Exits with 1 if a query fails.  The brain is a lot slower than a desktop, so
+// scale the times before comparing them against a budget.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "main.h"
+
+// Lives in libpros, which the host build doesn't link
+namespace pros {
+namespace usd {
+std::int32_t is_installed() { return 0; }
+}  // namespace usd
+}  // namespace pros
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+FieldPlanner planner;  // Too large for the stack
+
+struct Query {
+  const char *name;
+  PoseEstimator::pose start, goal;
+  bool match_heading;
+};
+
+double ms_since(Clock::time_point start, int repeats) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+}
+
+// Whether the robot fits along each segment, away from the ends where it may brush the walls
+bool segments_clear(const Query &query) {
+  const PoseEstimator::pose *waypoints = planner.get_waypoints();
+  for (int i = 0; i + 1 < planner.get_waypoint_count(); i++) {
+    const PoseEstimator::pose &from = waypoints[i], &to = waypoints[i + 1];
+    double heading = std::atan2(to.x - from.x, to.y - from.y) * 180 / M_PI;
+    for (int step = 0; step <= 100; step++) {
+      double t = step / 100.0;
+      PoseEstimator::pose pose{from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t, heading};
+      if (std::hypot(pose.x - query.start.x, pose.y - query.start.y) < 18 ||
+          std::hypot(pose.x - query.goal.x, pose.y - query.goal.y) < 18)
+        continue;
+      if (!planner.is_free(pose)) return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = argc > 1 ? std::atoi(argv[1]) : 50;
+  if (repeats <= 0) {
+    fprintf(stderr, "repeats must be positive\n");
+    return 1;
+  }
+
+  add_over_under_field(planner, false);
+  Clock::time_point start = Clock::now();
+  planner.build();
+  printf("build %29.3f ms\n", ms_since(start, 1));
+
+  const Query queries[] = {
+      {"start tile to far side", {-36, -58, 0}, {36, 58, 0}, true},
+      {"  any final heading", {-36, -58, 0}, {36, 58, 0}, false},
+      {"wall to wall", {-58, -30, 90}, {58, 30, 90}, true},
+      {"around a goal", {-40, 40, 90}, {40, 40, 270}, true},
+      {"around the barrier", {0, -30, 0}, {0, 30, 0}, true},
+      {"turn around first", {0, -30, 180}, {40, 30, 0}, true},
+      {"short hop", {-36, -58, 0}, {-36, -46, 0}, true},
+  };
+  bool ok = true;
+  for (const Query &query : queries) {
+    bool found = false;
+    start = Clock::now();
+    for (int i = 0; i < repeats; i++) found = planner.plan(query.start, query.goal, query.match_heading);
+    double ms = ms_since(start, repeats);
+    bool clear = found && segments_clear(query);
+    printf("%-22s %9.3f ms, %2d waypoints%s\n", query.name, ms, planner.get_waypoint_count(),
+           !found ? ", no path" : !clear ? ", hits an element" : "");
+    ok = ok && clear;
+  }
+
+  // With the short barriers in the way, the field is cut in half
+  planner.clear_obstacles();
+  add_over_under_field(planner, true);
+  planner.build();
+  start = Clock::now();
+  bool found = planner.plan({-58, -30, 90}, {58, 30, 90});
+  printf("%-22s %9.3f ms%s\n", "cut off", ms_since(start, 1), found ? ", found a path" : "");
+  ok = ok && !found;
+
+  printf(ok ? "ok\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
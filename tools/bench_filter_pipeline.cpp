@@ -0,0 +1,94 @@
+// Host benchmark for okapi::FilterPipeline against the same stages chained through Filter
+// pointers, like ComposableFilter runs them.
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude tools/bench_filter_pipeline.cpp -o bench_filter_pipeline
+// Use:    bench_filter_pipeline [samples]
+//
+// First checks that each pipeline's output, getOutput() and last stage match the chain exactly
+// on every sample.  Then prints the average time per sample of both.  EmaFilter and DemaFilter are
+// compiled into the prebuilt okapilib, so only header-only stages are covered.  Exits with 1 if
+// any output differs.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/filterPipeline.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/runningAverageFilter.hpp"
+#include "okapi/api/filter/slidingMedianFilter.hpp"
+
+// Lives in the prebuilt okapilib, which the host build doesn't link
+okapi::Filter::~Filter() = default;
+
+using namespace okapi;
+
+namespace {
+const std::size_t INPUT_SIZE = 4096;  // Readings are replayed from a buffer this size
+
+// Kept out of line so the chain can't be inlined away
+[[gnu::noinline]] double chain_filter(std::vector<std::shared_ptr<Filter>> &chain, double value) {
+  for (auto &stage : chain) value = stage->filter(value);
+  return value;
+}
+
+template <typename... Filters>
+bool check(const char *name, const std::vector<double> &input, int samples) {
+  std::vector<std::shared_ptr<Filter>> chain{std::make_shared<Filters>()...};
+  FilterPipeline<Filters...> pipeline;
+  Filter &as_filter = pipeline;
+  for (int i = 0; i < samples; i++) {
+    double value = input[i % INPUT_SIZE];
+    double expected = chain_filter(chain, value);
+    double result = as_filter.filter(value);
+    if (result != expected || pipeline.getOutput() != expected ||
+        pipeline.template getStage<sizeof...(Filters) - 1>().getOutput() != expected) {
+      printf("%s: differs from the chain at sample %d\n", name, i);
+      return false;
+    }
+  }
+
+  chain = {std::make_shared<Filters>()...};
+  FilterPipeline<Filters...> timed;
+  double chain_sum = 0, pipeline_sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; i++) chain_sum += chain_filter(chain, input[i % INPUT_SIZE]);
+  auto chain_end = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; i++) pipeline_sum += timed.filter(input[i % INPUT_SIZE]);
+  auto pipeline_end = std::chrono::steady_clock::now();
+  volatile double sink = chain_sum + pipeline_sum;  // Keeps the loops from being optimized away
+  (void)sink;
+
+  printf("%-48s %10.1f %13.1f\n", name,
+         std::chrono::duration<double, std::nano>(chain_end - start).count() / samples,
+         std::chrono::duration<double, std::nano>(pipeline_end - chain_end).count() / samples);
+  return true;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int samples = argc > 1 ? std::atoi(argv[1]) : 2000000;
+  if (samples <= 0) {
+    fprintf(stderr, "samples must be positive\n");
+    return 1;
+  }
+
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> reading(-600, 600);  // Motor velocities
+  std::vector<double> input(INPUT_SIZE);
+  for (double &r : input) r = reading(rng);
+
+  printf("%-48s %10s %13s\n", "stages", "chain", "pipeline");
+  printf("%-48s %10s %13s\n", "", "ns/sample", "ns/sample");
+  bool ok = check<RunningAverageFilter<4>, AverageFilter<3>>("RunningAverage<4>, Average<3>", input, samples) &&
+            check<MedianFilter<5>, RunningAverageFilter<8>>("Median<5>, RunningAverage<8>", input, samples) &&
+            check<SlidingMedianFilter<9>, AverageFilter<4>, RunningAverageFilter<16>>(
+                "SlidingMedian<9>, Average<4>, RunningAverage<16>", input, samples);
+  if (!ok) return 1;
+  printf("\noutputs match the chain on every sample\n");
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Host check for squiggles::FrictionCircleModel, the model that keeps a profile's total acceleration
+// within the grip of the wheels.
+//
+// Build:  g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/bench_friction_circle.cpp -o bench_friction_circle
+// Use:    bench_friction_circle
+//
+// Profiles a 3 m path, straight with a 0.4 m radius curve from 1.2 m to 1.8 m, with forward and
+// backward passes over the model's limits like SplineGenerator's.  Compares fixed limits of 1.5 m/s
+// and 4 m/s^2, the same limits capped at 1 m/s everywhere so the curve stays within 4 m/s^2, and
+// the fixed limits wrapped in a 4 m/s^2 friction circle.  Prints the time, the peak total
+// acceleration and the speed through the curve of each.  Exits with 1 if the friction circle
+// profile goes over its grip limit or isn't faster than the global speed cap.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "squiggles.hpp"
+
+using namespace squiggles;
+
+namespace {
+const double LENGTH = 3;         // Meters
+const double STEP = 0.001;       // Meters between profile points
+const double CURVE_START = 1.2;  // Meters
+const double CURVE_END = 1.8;    // Meters
+const double CURVATURE = 2.5;    // 1/m, a 0.4 m radius
+const double GRIP = 4;           // m/s^2
+
+// The same limits at every state
+class FixedModel : public PhysicalModel {
+  public:
+  FixedModel(double imax_vel, double imax_accel) : max_vel(imax_vel), max_accel(imax_accel) {}
+  Constraints constraints(const Pose, double, double) override { return Constraints(max_vel, max_accel); }
+  std::vector<double> linear_to_wheel_vels(double lin_vel, double) override { return {lin_vel, lin_vel}; }
+  std::string to_string() const override { return "FixedModel {}"; }
+
+  private:
+  double max_vel;
+  double max_accel;
+};
+
+struct Result {
+  double time;         // Seconds
+  double peak_accel;   // m/s^2, along the path and centripetal together
+  double curve_speed;  // m/s, in the middle of the curve
+};
+
+double curvature_at(int i) {
+  double s = i * STEP;
+  return s > CURVE_START && s < CURVE_END ? CURVATURE : 0;
+}
+
+Result profile(PhysicalModel &model) {
+  const int n = static_cast<int>(LENGTH / STEP);
+  const Pose pose(0, 0, 0);
+  std::vector<double> vel(n + 1);
+  for (int i = 0; i <= n; i++) vel[i] = model.constraints(pose, curvature_at(i), 0).max_vel;
+  vel[0] = vel[n] = 0;
+
+  for (int i = 1; i <= n; i++) {
+    double accel = std::max(0.0, model.constraints(pose, curvature_at(i - 1), vel[i - 1]).max_accel);
+    vel[i] = std::min(vel[i], std::sqrt(vel[i - 1] * vel[i - 1] + 2 * accel * STEP));
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    double accel = std::min(0.0, model.constraints(pose, curvature_at(i + 1), vel[i + 1]).min_accel);
+    vel[i] = std::min(vel[i], std::sqrt(vel[i + 1] * vel[i + 1] - 2 * accel * STEP));
+  }
+
+  Result result{0, 0, vel[static_cast<int>((CURVE_START + CURVE_END) / 2 / STEP)]};
+  for (int i = 0; i < n; i++) {
+    result.time += 2 * STEP / (vel[i] + vel[i + 1]);
+    double along = (vel[i + 1] * vel[i + 1] - vel[i] * vel[i]) / (2 * STEP);
+    double centripetal = vel[i] * vel[i] * curvature_at(i);
+    result.peak_accel = std::max(result.peak_accel, std::hypot(along, centripetal));
+  }
+  return result;
+}
+
+void print(const char *name, const Result &result) {
+  printf("%-28s %7.3f s %12.2f m/s^2 %12.2f m/s\n", name, result.time, result.peak_accel, result.curve_speed);
+}
+}  // namespace
+
+int main() {
+  FixedModel fixed(1.5, GRIP), capped(1.0, GRIP);
+  FrictionCircleModel circle(std::make_shared<FixedModel>(1.5, GRIP), GRIP);
+
+  Result no_grip = profile(fixed), global_cap = profile(capped), friction = profile(circle);
+  printf("%-28s %9s %18s %16s\n", "", "time", "peak accel", "curve speed");
+  print("no grip limit", no_grip);
+  print("global max_vel 1.0", global_cap);
+  print("friction circle 4 m/s^2", friction);
+
+  bool ok = friction.peak_accel <= GRIP + 1e-6 && friction.time < global_cap.time;
+  printf(ok ? "ok\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+// Host benchmark for okapi::SlidingMedianFilter against okapi::MedianFilter.
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude tools/bench_median.cpp -o bench_median
+// Use:    bench_median [readings]
+//
+// First checks SlidingMedianFilter against a sorted copy of the window for several window sizes,
+// then prints the average time per reading of both filters for windows from 3 to 257.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/slidingMedianFilter.hpp"
+
+// Lives in the prebuilt okapilib, which the host build doesn't link
+okapi::Filter::~Filter() = default;
+
+namespace {
+// Readings with plenty of repeats, so ties between equal values get exercised
+template <std::size_t n>
+bool check(std::mt19937 &rng) {
+  std::uniform_int_distribution<int> reading(-50, 50);
+  std::array<double, n> window{};
+  std::size_t oldest = 0;
+  okapi::SlidingMedianFilter<n> filter;
+  for (int i = 0; i < 20000; i++) {
+    double value = reading(rng) * 0.5;
+    window[oldest] = value;
+    oldest = (oldest + 1) % n;
+    std::array<double, n> sorted = window;
+    std::sort(sorted.begin(), sorted.end());
+    double expected = sorted[n % 2 == 1 ? n / 2 : n / 2 - 1];  // MedianFilter takes the lower median
+    if (filter.filter(value) != expected) {
+      printf("n=%zu: mismatch at reading %d\n", n, i);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F>
+double ns_per_reading(const std::vector<double> &readings) {
+  F filter;
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (double reading : readings) sum += filter.filter(reading);
+  auto end = std::chrono::steady_clock::now();
+  volatile double sink = sum;  // Keeps the loop from being optimized away
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(end - start).count() / readings.size();
+}
+
+template <std::size_t n>
+void bench(const std::vector<double> &readings) {
+  printf("%5zu %14.1f %21.1f\n", n, ns_per_reading<okapi::MedianFilter<n>>(readings),
+         ns_per_reading<okapi::SlidingMedianFilter<n>>(readings));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  if (count <= 0) {
+    fprintf(stderr, "readings must be positive\n");
+    return 1;
+  }
+
+  std::mt19937 rng(1);
+  bool ok = check<1>(rng) && check<2>(rng) && check<3>(rng) && check<4>(rng) && check<5>(rng) &&
+            check<8>(rng) && check<9>(rng) && check<31>(rng) && check<64>(rng) && check<101>(rng);
+  if (!ok) return 1;
+  printf("output matches a sorted window for n = 1 to 101\n\n");
+
+  std::uniform_real_distribution<double> reading(0, 1000);
+  std::vector<double> readings(count);
+  for (double &r : readings) r = reading(rng);
+
+  printf("%5s %14s %21s\n", "n", "MedianFilter", "SlidingMedianFilter");
+  printf("%5s %14s %21s\n", "", "ns/reading", "ns/reading");
+  bench<3>(readings);
+  bench<5>(readings);
+  bench<9>(readings);
+  bench<17>(readings);
+  bench<33>(readings);
+  bench<65>(readings);
+  bench<129>(readings);
+  bench<257>(readings);
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Host check for squiggles::MotorTankModel, the tank model whose limits come from the drive motors.
+//
+// Build:  g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/bench_motor_model.cpp -o bench_motor_model
+// Use:    bench_motor_model
+//
+// For a drive with three 600 rpm motors a side, 0.6 gearing, 3.25" wheels and 6.8 kg, prints the
+// straight acceleration limits as the robot speeds up and the free speed limit at two battery
+// voltages.  Then times a 1.2 m straight move profiled with a fixed 5 m/s^2 against one profiled
+// with the model, and checks every step of both against the model.  Last, sweeps curvature and
+// velocity, including states faster than the model allows, and checks that the bounds never cross,
+// that every state past the velocity limit is told to slow down, and that no side is asked to speed
+// up harder than its own motors can.  Exits with 1 if the model-limited profile breaks the limits
+// or any sweep check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "squiggles.hpp"
+
+using namespace squiggles;
+
+// Lives in the prebuilt okapilib, which the host build doesn't link.  Only the linear constraints
+// are kept, which is all a straight move needs and leaves the motor limits as the only curvature
+// limits in the sweep.
+TankModel::TankModel(double itrack_width, Constraints ilinear_constraints)
+  : track_width(itrack_width), linear_constraints(ilinear_constraints) {}
+Constraints TankModel::constraints(const Pose, double, double) { return linear_constraints; }
+std::vector<double> TankModel::linear_to_wheel_vels(double lin_vel, double curvature) {
+  return {lin_vel * (2 + curvature * track_width) / 2, lin_vel * (2 - curvature * track_width) / 2};
+}
+std::string TankModel::to_string() const { return "TankModel {}"; }
+
+namespace {
+const double TRACK = 0.3;            // Meters
+const double RADIUS = 0.041275;      // Meters, a 3.25" wheel
+const double RATIO = 0.6;            // Wheel speed per motor speed
+const double MASS = 6.8;             // Kilograms
+const double INERTIA = 0.25;         // Kilogram square meters
+const int MOTORS = 3;                // Per side
+const double DISTANCE = 1.2;         // Meters
+const double STEP = 0.001;           // Meters between profile points
+const double FIXED_ACCEL = 5;        // m/s^2
+const double FIXED_MAX_VEL = 1.556;  // The free speed limit at 12 V, m/s
+
+// Profiles a straight move with forward and backward passes, returns its time in seconds and
+// whether every step's acceleration is one the model allows
+double straight_move(MotorTankModel &model, bool use_model, bool &feasible) {
+  const int n = static_cast<int>(DISTANCE / STEP);
+  auto limits = [&](double vel) {
+    return use_model ? model.constraints(Pose(0, 0, 0), 0, vel)
+                     : Constraints(FIXED_MAX_VEL, FIXED_ACCEL, 100, 1000, -FIXED_ACCEL);
+  };
+
+  std::vector<double> vel(n + 1, 1e9);
+  vel[0] = vel[n] = 0;
+  for (int i = 1; i <= n; i++) {
+    Constraints c = limits(vel[i - 1]);
+    vel[i] = std::min({vel[i], c.max_vel, std::sqrt(vel[i - 1] * vel[i - 1] + 2 * c.max_accel * STEP)});
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    Constraints c = limits(vel[i + 1]);
+    vel[i] = std::min(vel[i], std::sqrt(vel[i + 1] * vel[i + 1] - 2 * c.min_accel * STEP));
+  }
+
+  double time = 0;
+  feasible = true;
+  for (int i = 0; i < n; i++) {
+    time += 2 * STEP / (vel[i] + vel[i + 1]);
+    double accel = (vel[i + 1] * vel[i + 1] - vel[i] * vel[i]) / (2 * STEP);
+    Constraints c = model.constraints(Pose(0, 0, 0), 0, vel[i]);
+    if (accel > c.max_accel + 1e-6 || accel < c.min_accel - 1e-6) feasible = false;
+  }
+  return time;
+}
+
+// The highest acceleration one side's motors allow, worked out apart from the model
+double side_max_accel(const MotorConstants &motor, double volts, double curvature, double vel, int side) {
+  double wheel_scale = 1 + side * curvature * TRACK / 2;
+  double side_mass = MASS / 2 + side * INERTIA * curvature / TRACK;
+  double motor_speed = vel * wheel_scale / (RADIUS * RATIO);
+  double force_per_torque = MOTORS / (RATIO * RADIUS);
+  double force = side_mass > 0 ? motor.max_torque(motor_speed, volts) : motor.min_torque(motor_speed, volts);
+  return force * force_per_torque / side_mass;
+}
+}  // namespace
+
+int main() {
+  MotorConstants motor = MotorConstants::v5_smart_motor(600);
+  MotorTankModel model(TRACK, Constraints(3, 20, 100), motor, MOTORS, RADIUS, RATIO, MASS, INERTIA);
+
+  printf("straight, 12 V\n");
+  for (double vel : {0.0, 0.5, 1.0, 1.4}) {
+    Constraints c = model.constraints(Pose(0, 0, 0), 0, vel);
+    printf("  at %.1f m/s: accel [%6.2f, %6.2f] m/s^2\n", vel, c.min_accel, c.max_accel);
+  }
+  for (double volts : {12.0, 10.5}) {
+    model.set_battery_voltage(volts);
+    printf("free speed limit at %4.1f V: %.3f m/s\n", volts, model.constraints(Pose(0, 0, 0), 0, 0).max_vel);
+  }
+  model.set_battery_voltage(12);
+
+  bool fixed_feasible, model_feasible;
+  double fixed_time = straight_move(model, false, fixed_feasible);
+  double model_time = straight_move(model, true, model_feasible);
+  printf("\n%.1f m straight move\n", DISTANCE);
+  printf("  fixed %.0f m/s^2  %.3f s, within the motor limits: %s\n", FIXED_ACCEL, fixed_time,
+         fixed_feasible ? "yes" : "no");
+  printf("  motor model     %.3f s, within the motor limits: %s\n", model_time, model_feasible ? "yes" : "no");
+
+  // Past the velocity limit the sides can have no acceleration in common, which must resolve to slowing down
+  int states = 0, too_fast = 0, crossed = 0, not_slowing = 0, over_side = 0;
+  for (double volts : {12.0, 10.5}) {
+    model.set_battery_voltage(volts);
+    for (double curvature = -8; curvature <= 8; curvature += 0.25) {
+      for (double vel = 0; vel <= 2; vel += 0.05, states++) {
+        Constraints c = model.constraints(Pose(0, 0, 0), curvature, vel);
+        if (c.min_accel > c.max_accel) crossed++;
+        for (int side : {1, -1})
+          if (c.max_accel > side_max_accel(motor, volts, curvature, vel, side) + 1e-9) over_side++;
+        if (vel > c.max_vel) {
+          too_fast++;
+          if (c.max_accel >= 0) not_slowing++;
+        }
+      }
+    }
+  }
+  printf("\n%d states swept, %d past the velocity limit\n", states, too_fast);
+  printf("  %d with crossed bounds, %d not slowing down, %d asking a side for more than it has\n", crossed,
+         not_slowing, over_side);
+
+  bool ok = model_feasible && crossed == 0 && not_slowing == 0 && over_side == 0;
+  printf(ok ? "ok\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
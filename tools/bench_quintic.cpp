@@ -0,0 +1,135 @@
+// Host benchmark for the batched squiggles::QuinticPolynomial calls against the scalar ones.
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/bench_quintic.cpp -o bench_quintic
+// Use:    bench_quintic [repeats]
+//
+// Samples an x and a y polynomial at 500, 1000 and 2000 time stamps, the size of typical paths,
+// and prints the time per path of:
+//   - position, heading and curvature from the scalar calls, and from sample_planar()
+//   - positions only from calc_point() in a loop, and from calc_points()
+// It also prints the largest difference between the scalar and batched results.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "math/quinticpolynomial.hpp"
+
+using squiggles::PlanarSamples;
+using squiggles::QuinticPolynomial;
+using Clock = std::chrono::steady_clock;
+
+// The scalar calls live in the prebuilt squiggles library, which the host build doesn't link.
+// These are written the same way, in power form, and kept out of line like the library's.
+namespace squiggles {
+[[gnu::noinline]] QuinticPolynomial::QuinticPolynomial(double s_p, double s_v, double s_a, double g_p, double g_v,
+                                                       double g_a, double t) {
+  a0 = s_p;
+  a1 = s_v;
+  a2 = s_a / 2;
+  double t2 = t * t, t3 = t2 * t, t4 = t3 * t, t5 = t4 * t;
+  double b0 = g_p - a0 - a1 * t - a2 * t2;
+  double b1 = g_v - a1 - 2 * a2 * t;
+  double b2 = g_a - 2 * a2;
+  a3 = (10 * b0 - 4 * b1 * t + 0.5 * b2 * t2) / t3;
+  a4 = (-15 * b0 + 7 * b1 * t - b2 * t2) / t4;
+  a5 = (6 * b0 - 3 * b1 * t + 0.5 * b2 * t2) / t5;
+}
+
+[[gnu::noinline]] double QuinticPolynomial::calc_point(double t) {
+  return a0 + a1 * t + a2 * std::pow(t, 2) + a3 * std::pow(t, 3) + a4 * std::pow(t, 4) + a5 * std::pow(t, 5);
+}
+
+[[gnu::noinline]] double QuinticPolynomial::calc_first_derivative(double t) {
+  return a1 + 2 * a2 * t + 3 * a3 * std::pow(t, 2) + 4 * a4 * std::pow(t, 3) + 5 * a5 * std::pow(t, 4);
+}
+
+[[gnu::noinline]] double QuinticPolynomial::calc_second_derivative(double t) {
+  return 2 * a2 + 6 * a3 * t + 12 * a4 * std::pow(t, 2) + 20 * a5 * std::pow(t, 3);
+}
+
+[[gnu::noinline]] double QuinticPolynomial::calc_third_derivative(double t) {
+  return 6 * a3 + 24 * a4 * t + 60 * a5 * std::pow(t, 2);
+}
+}  // namespace squiggles
+
+namespace {
+double us_per_repeat(Clock::time_point start, Clock::time_point end, int repeats) {
+  return std::chrono::duration<double, std::micro>(end - start).count() / repeats;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = argc > 1 ? std::atoi(argv[1]) : 2000;
+  if (repeats <= 0) {
+    fprintf(stderr, "repeats must be positive\n");
+    return 1;
+  }
+
+  const double duration = 2.0;
+  QuinticPolynomial x(0, 0.5, 0, 1.2, 0.3, 0, duration);
+  QuinticPolynomial y(0, 0, 0, 0.8, 0.4, 0, duration);
+  PlanarSamples samples;
+  double sink = 0;  // Keeps the loops from being optimized away
+
+  printf("%5s %12s %14s %16s %12s %9s\n", "n", "scalar pose", "sample_planar", "calc_point loop", "calc_points",
+         "max diff");
+  for (int n : {500, 1000, 2000}) {
+    std::vector<double> t(n);
+    for (int i = 0; i < n; i++) t[i] = duration * i / (n - 1);
+    std::vector<double> px(n), py(n), yaw(n), curvature(n), out(n);
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+      for (int i = 0; i < n; i++) {
+        double vx = x.calc_first_derivative(t[i]), vy = y.calc_first_derivative(t[i]);
+        double ax = x.calc_second_derivative(t[i]), ay = y.calc_second_derivative(t[i]);
+        px[i] = x.calc_point(t[i]);
+        py[i] = y.calc_point(t[i]);
+        yaw[i] = std::atan2(vy, vx);
+        curvature[i] = (vx * ay - vy * ax) / std::pow(vx * vx + vy * vy, 1.5);
+      }
+      sink += curvature[n / 2];
+    }
+    Clock::time_point scalar_end = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+      QuinticPolynomial::sample_planar(x, y, t, samples);
+      sink += samples.curvature[n / 2];
+    }
+    Clock::time_point planar_end = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+      for (int i = 0; i < n; i++) out[i] = x.calc_point(t[i]);
+      sink += out[n / 2];
+    }
+    Clock::time_point loop_end = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+      x.calc_points(t.data(), n, out.data());
+      sink += out[n / 2];
+    }
+    Clock::time_point points_end = Clock::now();
+
+    double diff = 0;
+    for (int i = 0; i < n; i++) {
+      diff = std::max({diff, std::fabs(px[i] - samples.x[i]), std::fabs(py[i] - samples.y[i]),
+                       std::fabs(yaw[i] - samples.yaw[i]), std::fabs(curvature[i] - samples.curvature[i]),
+                       std::fabs(out[i] - x.calc_point(t[i]))});
+    }
+    x.calc_first_derivatives(t.data(), n, out.data());
+    for (int i = 0; i < n; i++) diff = std::max(diff, std::fabs(out[i] - x.calc_first_derivative(t[i])));
+    x.calc_second_derivatives(t.data(), n, out.data());
+    for (int i = 0; i < n; i++) diff = std::max(diff, std::fabs(out[i] - x.calc_second_derivative(t[i])));
+    x.calc_third_derivatives(t.data(), n, out.data());
+    for (int i = 0; i < n; i++) diff = std::max(diff, std::fabs(out[i] - x.calc_third_derivative(t[i])));
+
+    printf("%5d %9.2f us %11.2f us %13.2f us %9.2f us %9.1e\n", n, us_per_repeat(start, scalar_end, repeats),
+           us_per_repeat(scalar_end, planar_end, repeats), us_per_repeat(planar_end, loop_end, repeats),
+           us_per_repeat(loop_end, points_end, repeats), diff);
+  }
+
+  volatile double keep = sink;
+  (void)keep;
+  return 0;
+}
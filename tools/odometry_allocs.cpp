@@ -0,0 +1,159 @@
+// Host test that okapi::FixedTwoEncoderOdometry and okapi::FixedThreeEncoderOdometry never
+// allocate in step().
+//
+// Build:  g++ -std=c++17 -O2 -DTHREADS_STD -Iinclude tools/odometry_allocs.cpp -o odometry_allocs
+// Use:    odometry_allocs [steps]
+//
+// Replaces the global operator new with one that counts calls, then steps both odometries with
+// encoders that keep turning.  Prints allocations and time per step, and exits with 1 if step()
+// allocated at all.  The okapilib parts the odometries need from outside the headers are stubbed
+// below, just enough to run.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "okapi/api/odometry/fixedThreeEncoderOdometry.hpp"
+#include "okapi/api/odometry/fixedTwoEncoderOdometry.hpp"
+
+using namespace okapi;
+
+namespace {
+std::size_t allocations = 0;
+}  // namespace
+
+void *operator new(std::size_t size) {
+  allocations++;
+  void *p = std::malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Stand-ins for okapilib, which the host build doesn't link
+namespace okapi {
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+Logger::~Logger() {}
+std::shared_ptr<Logger> Logger::getDefaultLogger() { return defaultLogger; }
+RotarySensor::~RotarySensor() = default;
+
+AbstractTimer::AbstractTimer(QTime ifirstCalled)
+  : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0_ms), repeatMark(-1_ms) {}
+AbstractTimer::~AbstractTimer() = default;
+QTime AbstractTimer::getDt() {
+  QTime now = millis();
+  QTime dt = now - lastCalled;
+  lastCalled = now;
+  return dt;
+}
+QTime AbstractTimer::readDt() const { return millis() - lastCalled; }
+QTime AbstractTimer::getStartingTime() const { return firstCalled; }
+QTime AbstractTimer::getDtFromStart() const { return millis() - firstCalled; }
+void AbstractTimer::placeMark() { mark = millis(); }
+QTime AbstractTimer::clearMark() { return mark; }
+void AbstractTimer::placeHardMark() {}
+QTime AbstractTimer::clearHardMark() { return hardMark; }
+QTime AbstractTimer::getDtFromMark() const { return millis() - mark; }
+QTime AbstractTimer::getDtFromHardMark() const { return 0_ms; }
+bool AbstractTimer::repeat(QTime) { return false; }
+bool AbstractTimer::repeat(QFrequency) { return false; }
+
+TimeUtil::TimeUtil(const Supplier<std::unique_ptr<AbstractTimer>> &itimerSupplier,
+                   const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+                   const Supplier<std::unique_ptr<SettledUtil>> &isettledUtilSupplier)
+  : timerSupplier(itimerSupplier), rateSupplier(irateSupplier), settledUtilSupplier(isettledUtilSupplier) {}
+std::unique_ptr<AbstractTimer> TimeUtil::getTimer() const { return timerSupplier.get(); }
+
+// Only the fields odometry reads: {straight, turn, middle wheel distance, middle}
+ChassisScales::ChassisScales(const std::initializer_list<double> &iscales, double itpr, const std::shared_ptr<Logger> &) {
+  const double *scale = iscales.begin();
+  straight = scale[0];
+  turn = scale[1];
+  middleWheelDistance = scale[2] * meter;
+  middle = scale[3];
+  wheelTrack = straight / turn * meter;
+  tpr = itpr;
+}
+}  // namespace okapi
+
+namespace {
+// One tick of 10 ms per call of millis(), so every step() sees time pass
+struct TickTimer : AbstractTimer {
+  TickTimer() : AbstractTimer(0_ms) {}
+  QTime millis() const override { return (now += 10) * millisecond; }
+  mutable double now = 0;
+};
+
+struct Encoder : ContinuousRotarySensor {
+  double ticks = 0;
+  double get() const override { return ticks; }
+  std::int32_t reset() override {
+    ticks = 0;
+    return 0;
+  }
+  double controllerGet() override { return ticks; }
+};
+
+// Steps an odometry while its encoders turn at changing speeds, returns allocations per step
+double run(Odometry &odom, Encoder &left, Encoder &right, Encoder &middle, int steps, double &ons_per_step) {
+  std::size_t before = allocations;
+  double ns = 0;
+  for (int i = 1; i <= steps; i++) {
+    left.ticks += 20 + 15 * std::sin(i * 1e-3);
+    right.ticks += 20 + 15 * std::cos(i * 1.3e-3);
+    middle.ticks += 5 * std::sin(i * 7e-4);
+    auto start = std::chrono::steady_clock::now();
+    odom.step();
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  ons_per_step = ns / steps;
+  return static_cast<double>(allocations - before) / steps;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int steps = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  if (steps <= 0) {
+    fprintf(stderr, "steps must be positive\n");
+    return 1;
+  }
+
+  TimeUtil time_util(Supplier<std::unique_ptr<AbstractTimer>>([] { return std::make_unique<TickTimer>(); }),
+                     Supplier<std::unique_ptr<AbstractRate>>([] { return std::unique_ptr<AbstractRate>(); }),
+                     Supplier<std::unique_ptr<SettledUtil>>([] { return std::unique_ptr<SettledUtil>(); }));
+  auto left = std::make_shared<Encoder>();
+  auto right = std::make_shared<Encoder>();
+  auto middle = std::make_shared<Encoder>();
+  auto logger = std::make_shared<Logger>();  // Logs nothing
+  ChassisScales scales({1000.0, 3000.0, 0.1, 1200.0}, 360, logger);
+
+  FixedTwoEncoderOdometry two(time_util, nullptr, left, right, scales, logger);
+  FixedThreeEncoderOdometry three(time_util, nullptr, left, right, middle, scales, logger);
+  if (allocations == 0) {
+    printf("FAIL: the setup above allocated, but the counter saw nothing\n");
+    return 1;
+  }
+
+  double two_ns, three_ns;
+  double two_allocs = run(two, *left, *right, *middle, steps, two_ns);
+  left->reset();
+  right->reset();
+  middle->reset();
+  double three_allocs = run(three, *left, *right, *middle, steps, three_ns);
+
+  printf("%d steps\n", steps);
+  printf("FixedTwoEncoderOdometry    %.3f allocations/step, %.1f ns/step\n", two_allocs, two_ns);
+  printf("FixedThreeEncoderOdometry  %.3f allocations/step, %.1f ns/step\n", three_allocs, three_ns);
+  if (two_allocs != 0 || three_allocs != 0) {
+    printf("FAIL: step() allocated\n");
+    return 1;
+  }
+  printf("ok\n");
+  return 0;
+}
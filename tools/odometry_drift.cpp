@@ -0,0 +1,166 @@
+// Host test of how far okapi::ImuThreeEncoderOdometry drifts against
+// okapi::FixedThreeEncoderOdometry when the wheels scrub.
+//
+// Build:  g++ -std=c++17 -O2 -DTHREADS_STD -Iinclude tools/odometry_drift.cpp -o odometry_drift
+// Use:    odometry_drift
+//
+// Simulates 30 s of driving, turning and sliding sideways.  The left and right encoders see 8%
+// more turning than the robot does, like scrubbing wheels, and the IMU drifts 0.05 degrees a
+// second.  Prints the true pose and both odometries' poses for the IMU only, blended with the
+// encoders below 5 rpm, and with a bad IMU reading and an IMU reset partway through.  Exits with 1
+// if the IMU odometry ends more than 5 cm or 3 degrees off.  A blend rate near the robot's turning
+// rates mixes the scrub back in, so keep it low.  The okapilib parts the odometries need from
+// outside the headers are stubbed below, just enough to run.
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <memory>
+
+#include "okapi/api/odometry/imuThreeEncoderOdometry.hpp"
+
+using namespace okapi;
+
+// Stand-ins for okapilib, which the host build doesn't link
+namespace okapi {
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+Logger::~Logger() {}
+std::shared_ptr<Logger> Logger::getDefaultLogger() { return defaultLogger; }
+RotarySensor::~RotarySensor() = default;
+
+AbstractTimer::AbstractTimer(QTime ifirstCalled)
+  : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0_ms), repeatMark(-1_ms) {}
+AbstractTimer::~AbstractTimer() = default;
+QTime AbstractTimer::getDt() {
+  QTime now = millis();
+  QTime dt = now - lastCalled;
+  lastCalled = now;
+  return dt;
+}
+QTime AbstractTimer::readDt() const { return millis() - lastCalled; }
+QTime AbstractTimer::getStartingTime() const { return firstCalled; }
+QTime AbstractTimer::getDtFromStart() const { return millis() - firstCalled; }
+void AbstractTimer::placeMark() { mark = millis(); }
+QTime AbstractTimer::clearMark() { return mark; }
+void AbstractTimer::placeHardMark() {}
+QTime AbstractTimer::clearHardMark() { return hardMark; }
+QTime AbstractTimer::getDtFromMark() const { return millis() - mark; }
+QTime AbstractTimer::getDtFromHardMark() const { return 0_ms; }
+bool AbstractTimer::repeat(QTime) { return false; }
+bool AbstractTimer::repeat(QFrequency) { return false; }
+
+TimeUtil::TimeUtil(const Supplier<std::unique_ptr<AbstractTimer>> &itimerSupplier,
+                   const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+                   const Supplier<std::unique_ptr<SettledUtil>> &isettledUtilSupplier)
+  : timerSupplier(itimerSupplier), rateSupplier(irateSupplier), settledUtilSupplier(isettledUtilSupplier) {}
+std::unique_ptr<AbstractTimer> TimeUtil::getTimer() const { return timerSupplier.get(); }
+
+// Only the fields odometry reads: {straight, turn, middle wheel distance, middle}
+ChassisScales::ChassisScales(const std::initializer_list<double> &iscales, double itpr, const std::shared_ptr<Logger> &) {
+  const double *scale = iscales.begin();
+  straight = scale[0];
+  turn = scale[1];
+  middleWheelDistance = scale[2] * meter;
+  middle = scale[3];
+  wheelTrack = straight / turn * meter;
+  tpr = itpr;
+}
+}  // namespace okapi
+
+namespace {
+const double DT = 0.01;
+const int STEPS = 3000;
+const double TICKS_PER_METER = 10000;
+const double TRACK = 0.3;          // Meters
+const double MIDDLE_OFFSET = 0.1;  // Meters from the center to the middle wheel
+const double SCRUB = 1.08;         // Encoder turning per true turning
+const double IMU_DRIFT = 0.0005;   // Degrees per step
+
+double now_ms = 0;
+
+struct SimTimer : AbstractTimer {
+  SimTimer() : AbstractTimer(0_ms) {}
+  QTime millis() const override { return now_ms * millisecond; }
+};
+
+struct Sensor : ContinuousRotarySensor {
+  double value = 0;
+  double get() const override { return value; }
+  std::int32_t reset() override {
+    value = 0;
+    return 0;
+  }
+  double controllerGet() override { return value; }
+};
+
+struct Pose {
+  double x, y, theta;  // Meters, meters, degrees
+};
+
+void print(const char *name, const Pose &pose, const Pose &truth) {
+  printf("  %-16s (%7.3f, %7.3f, %6.1f deg)  off by %.3f m, %.1f deg\n", name, pose.x, pose.y, pose.theta,
+         std::hypot(pose.x - truth.x, pose.y - truth.y), std::fabs(pose.theta - truth.theta));
+}
+
+Pose pose_of(Odometry &odom) {
+  OdomState state = odom.getState();
+  return {state.x.convert(meter), state.y.convert(meter), state.theta.convert(degree)};
+}
+
+// Drives the robot and both odometries, returns whether the IMU odometry stayed close
+bool run(const char *name, const TimeUtil &time_util, const ChassisScales &scales, double blend_rpm, bool glitches) {
+  auto left = std::make_shared<Sensor>(), right = std::make_shared<Sensor>(), middle = std::make_shared<Sensor>();
+  auto imu = std::make_shared<Sensor>();
+  auto logger = std::make_shared<Logger>();  // Logs nothing
+  now_ms = 0;
+  FixedThreeEncoderOdometry encoder_odom(time_util, nullptr, left, right, middle, scales, logger);
+  ImuThreeEncoderOdometry imu_odom(time_util, nullptr, left, right, middle, imu, scales, blend_rpm * rpm, logger);
+
+  // x forward, y right, theta clockwise, like okapi
+  double x = 0, y = 0, theta = 0, left_m = 0, right_m = 0, middle_m = 0, imu_offset = 0;
+  for (int i = 1; i <= STEPS; i++) {
+    now_ms = i * DT * 1000;
+    double forward = 0.8 * std::sin(i * 2e-3) + 0.3, turn = 2.5 * std::sin(i * 5e-3), slide = 0.1 * std::sin(i * 3e-3);
+    double d_theta = turn * DT, mid = theta + d_theta / 2;
+    x += forward * DT * std::cos(mid) - slide * DT * std::sin(mid);
+    y += forward * DT * std::sin(mid) + slide * DT * std::cos(mid);
+    theta += d_theta;
+
+    left_m += forward * DT + SCRUB * d_theta * TRACK / 2;
+    right_m += forward * DT - SCRUB * d_theta * TRACK / 2;
+    middle_m += slide * DT + d_theta * MIDDLE_OFFSET;
+    left->value = std::round(left_m * TICKS_PER_METER);
+    right->value = std::round(right_m * TICKS_PER_METER);
+    middle->value = std::round(middle_m * TICKS_PER_METER);
+
+    if (glitches && i == 2000) imu_offset = -(theta * 180 / M_PI + IMU_DRIFT * i);  // Reset to 0
+    imu->value = theta * 180 / M_PI + IMU_DRIFT * i + imu_offset;
+    if (glitches && i == 1000) imu->value = std::numeric_limits<double>::quiet_NaN();
+
+    encoder_odom.step();
+    imu_odom.step();
+  }
+
+  Pose truth{x, y, theta * 180 / M_PI}, encoder = pose_of(encoder_odom), with_imu = pose_of(imu_odom);
+  printf("%s\n", name);
+  printf("  %-16s (%7.3f, %7.3f, %6.1f deg)\n", "truth", truth.x, truth.y, truth.theta);
+  print("encoder heading", encoder, truth);
+  print("imu heading", with_imu, truth);
+  return std::hypot(with_imu.x - truth.x, with_imu.y - truth.y) < 0.05 && std::fabs(with_imu.theta - truth.theta) < 3;
+}
+}  // namespace
+
+int main() {
+  TimeUtil time_util(Supplier<std::unique_ptr<AbstractTimer>>([] { return std::make_unique<SimTimer>(); }),
+                     Supplier<std::unique_ptr<AbstractRate>>([] { return std::unique_ptr<AbstractRate>(); }),
+                     Supplier<std::unique_ptr<SettledUtil>>([] { return std::unique_ptr<SettledUtil>(); }));
+  ChassisScales scales({TICKS_PER_METER, TICKS_PER_METER / TRACK, MIDDLE_OFFSET, TICKS_PER_METER}, 360);
+
+  bool ok = run("imu only", time_util, scales, 0, false);
+  ok = run("blended below 5 rpm", time_util, scales, 5, false) && ok;
+  ok = run("imu only, bad reading and reset", time_util, scales, 0, true) && ok;
+  printf(ok ? "ok\n" : "FAIL: the imu odometry drifted\n");
+  return ok ? 0 : 1;
+}
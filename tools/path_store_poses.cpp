@@ -0,0 +1,157 @@
+// Host test of okapi::PathStore: the motor rpm and reference poses it stores for a path, and that
+// its handles survive removals.
+//
+// Build:  g++ -std=gnu++17 -O2 -DTHREADS_STD -Iinclude -iquote include/okapi/squiggles tools/path_store_poses.cpp -o path_store_poses
+// Use:    path_store_poses
+//
+// Checks the rpm for 1 m/s against the hand value, that makeSetpoint() gives the rpm add() stores,
+// and that the poses add() integrates match the exact motion of holding each point's wheel
+// velocities for one step, on a constant arc and on an S-curve.  Then removes a path so the arena
+// compacts, and checks that the other paths keep their handles and points and that lookups don't
+// allocate.  Exits with 1 if anything is off.  The okapilib parts the store needs from outside the
+// headers are stubbed below, just enough to run.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "okapi/api/control/util/pathStore.hpp"
+
+using namespace okapi;
+
+namespace {
+std::size_t allocations = 0;
+}  // namespace
+
+void *operator new(std::size_t size) {
+  allocations++;
+  void *p = std::malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Stand-ins for okapilib, which the host build doesn't link
+namespace okapi {
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+Logger::~Logger() {}
+std::shared_ptr<Logger> Logger::getDefaultLogger() { return defaultLogger; }
+
+// Only the fields the store reads: {wheel diameter, wheel track}
+ChassisScales::ChassisScales(const std::initializer_list<QLength> &idimensions, double itpr,
+                             const std::shared_ptr<Logger> &) {
+  wheelDiameter = idimensions.begin()[0];
+  wheelTrack = idimensions.begin()[1];
+  tpr = itpr;
+}
+}  // namespace okapi
+
+namespace {
+const double DT = 0.01;
+const double TRACK = 0.3;           // Meters
+const double POSE_TOLERANCE = 1e-4;  // Meters and radians
+
+using Wheels = std::vector<std::pair<double, double>>;  // Left and right wheel velocities, m/s
+
+std::vector<squiggles::ProfilePoint> profile(const Wheels &wheels) {
+  std::vector<squiggles::ProfilePoint> path;
+  for (std::size_t i = 0; i < wheels.size(); i++)
+    path.emplace_back(squiggles::ControlVector(), std::vector<double>{wheels[i].first, wheels[i].second}, 0, i * DT);
+  return path;
+}
+
+// Checks every point's pose against driving the wheel velocities before it exactly, as arcs
+bool check_poses(const char *name, PathStore &store, const Wheels &wheels) {
+  auto span = store.get(store.add(profile(wheels), DT));
+  double x = 0, y = 0, theta = 0, worst = 0;
+  for (std::size_t i = 0; i < span.size; i++) {
+    const auto &point = span.points[i];
+    worst = std::max({worst, std::hypot(point.x - x, point.y - y), std::fabs(point.theta - theta)});
+
+    double v = (wheels[i].first + wheels[i].second) / 2, w = (wheels[i].first - wheels[i].second) / TRACK;
+    double expected_left = store.convertLinearToRotational(wheels[i].first * mps);
+    auto made = store.makeSetpoint(point.x, point.y, point.theta, point.linearVel, point.angularVel);
+    if (std::fabs(point.linearVel - v) > 1e-12 || std::fabs(point.angularVel - w) > 1e-12 ||
+        std::fabs(point.leftRPM - expected_left) > 1e-9 || std::fabs(made.leftRPM - point.leftRPM) > 1e-9 ||
+        std::fabs(made.rightRPM - point.rightRPM) > 1e-9) {
+      printf("%s: point %zu has the wrong velocities\n", name, i);
+      return false;
+    }
+
+    // x forward, y right, theta clockwise
+    if (std::fabs(w) < 1e-12) {
+      x += v * DT * std::cos(theta);
+      y += v * DT * std::sin(theta);
+    } else {
+      x += v / w * (std::sin(theta + w * DT) - std::sin(theta));
+      y += v / w * (std::cos(theta) - std::cos(theta + w * DT));
+    }
+    theta += w * DT;
+  }
+  printf("%-10s %4zu points, ends at (%6.3f, %6.3f, %6.1f deg), worst pose error %.2e\n", name, span.size, x, y,
+         theta * 180 / M_PI, worst);
+  return worst < POSE_TOLERANCE;
+}
+
+bool same_points(const PathStore::Span &span, const std::vector<PathStore::Setpoint> &copy) {
+  if (span.size != copy.size()) return false;
+  for (std::size_t i = 0; i < span.size; i++)
+    if (span.points[i].leftRPM != copy[i].leftRPM || span.points[i].x != copy[i].x) return false;
+  return true;
+}
+}  // namespace
+
+int main() {
+  PathStore store(ChassisScales({4_in, TRACK * meter}, 900),
+                  AbstractMotor::GearsetRatioPair(AbstractMotor::gearset::green, 0.5));
+  store.reserve(16, 10000);
+  bool ok = true;
+
+  // 1 m/s on a 4" wheel is 1 / (pi * 0.1016) rev/s, times the 0.5 ratio
+  double hand = 60 / (M_PI * 0.1016) * 0.5, got = store.convertLinearToRotational(1 * mps);
+  printf("1 m/s is %.3f rpm, by hand %.3f\n", got, hand);
+  ok = std::fabs(got - hand) < 1e-9 && ok;
+
+  Wheels arc(300, {1.2, 0.8}), s_curve;
+  for (int i = 0; i < 300; i++) {
+    double t = i * DT, v = std::min({1.0, t * 2, (3 - t) * 2}), w = 1.2 * std::sin(t * 2);
+    s_curve.emplace_back(v + w * TRACK / 2, v - w * TRACK / 2);
+  }
+  ok = check_poses("arc", store, arc) && ok;
+  ok = check_poses("s-curve", store, s_curve) && ok;
+
+  // Removing the middle path leaves more garbage than live points, so the arena compacts
+  store.clear();
+  auto a = store.add(profile(Wheels(100, {1, 1})), DT), b = store.add(profile(s_curve), DT),
+       c = store.add(profile(Wheels(150, {1.2, 0.8})), DT, PathFollower::ramsete);
+  const PathStore::Setpoint *c_before = store.get(c).points;
+  std::vector<PathStore::Setpoint> a_copy(store.get(a).points, store.get(a).points + store.get(a).size),
+    c_copy(store.get(c).points, store.get(c).points + store.get(c).size);
+  bool removed = store.remove(b) && !store.contains(b) && !store.remove(b);
+  auto d = store.add(profile(Wheels(10, {0.5, 0.5})), DT);
+  bool compacted = store.get(c).points != c_before;
+  bool kept = same_points(store.get(a), a_copy) && same_points(store.get(c), c_copy) &&
+              store.get(c).follower == PathFollower::ramsete && store.get(b).size == 0 && d != a && d != b && d != c;
+  printf("after removing a path: arena %s, other paths %s\n", compacted ? "compacted" : "not compacted",
+         removed && kept ? "unchanged" : "changed");
+  ok = compacted && removed && kept && ok;
+
+  std::size_t before = allocations;
+  double sum = 0;
+  for (int i = 0; i < 100000; i++) {
+    auto span = store.get(i % 2 ? a : c);
+    sum += span.points[i % span.size].rightRPM;
+  }
+  volatile double sink = sum;  // Keeps the loop from being optimized away
+  (void)sink;
+  printf("100000 lookups allocated %zu times\n", allocations - before);
+  ok = allocations == before && ok;
+
+  printf(ok ? "ok\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// Host test of okapi::AsyncFlatMotionProfileController following a PathFollower::ramsete path on a
+// simulated drive whose wheels slip.
+//
+// Build:  g++ -std=gnu++17 -O2 -DTHREADS_STD -Iinclude -iquote include/okapi/squiggles tools/ramsete_convergence.cpp -o ramsete_convergence
+// Use:    ramsete_convergence
+//
+// Runs the controller's own path loop on a 3 s S-curve, stepping a simulated drive by the wheel
+// velocities it commands every 10 ms.  The robot starts away from the origin, so the path's frame
+// differs from the odometry's, and the odometry reads the true pose, like tracking wheels would.
+// Each run is done forwards, backwards, mirrored and both, open-loop and with RAMSETE, once with
+// the left wheels slipping 20% for a second and once without.  Prints how far each run ends from
+// where the path ends, and exits with 1 if RAMSETE doesn't stay on the path without slip or doesn't
+// end at least three times closer than open-loop with it.  The okapilib parts the controller needs
+// from outside the headers are stubbed below, just enough to run.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "okapi/api/control/async/asyncFlatMotionProfileController.hpp"
+
+using namespace okapi;
+
+// Stand-ins for okapilib, which the host build doesn't link
+namespace okapi {
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+Logger::~Logger() {}
+std::shared_ptr<Logger> Logger::getDefaultLogger() { return defaultLogger; }
+AbstractRate::~AbstractRate() = default;
+
+TimeUtil::TimeUtil(const Supplier<std::unique_ptr<AbstractTimer>> &itimerSupplier,
+                   const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+                   const Supplier<std::unique_ptr<SettledUtil>> &isettledUtilSupplier)
+  : timerSupplier(itimerSupplier), rateSupplier(irateSupplier), settledUtilSupplier(isettledUtilSupplier) {}
+std::unique_ptr<AbstractRate> TimeUtil::getRate() const { return rateSupplier.get(); }
+
+// Only the fields the controller reads: {wheel diameter, wheel track}
+ChassisScales::ChassisScales(const std::initializer_list<QLength> &idimensions, double itpr,
+                             const std::shared_ptr<Logger> &) {
+  wheelDiameter = idimensions.begin()[0];
+  wheelTrack = idimensions.begin()[1];
+  tpr = itpr;
+}
+}  // namespace okapi
+
+namespace {
+const double DT = 0.01;
+const double TRACK = 0.3;  // Meters
+const double START_X = 1, START_Y = 2, START_THETA = 0.5;
+const double SLIP = 0.8;  // Left wheel travel per commanded travel while slipping
+const int SLIP_START = 100, SLIP_END = 200;
+
+// A drive that moves by the wheel velocities last commanded, and the odometry that reads its pose
+struct SimDrive : ChassisModel, Odometry {
+  double x, y, theta;
+  double left_command, right_command;  // Fractions of the gearset's rpm
+  double rpm_per_mps = 0;
+  bool slipping;
+  int steps;
+
+  // Puts the robot back at the start
+  void reset(bool islipping) {
+    x = START_X;
+    y = START_Y;
+    theta = START_THETA;
+    left_command = right_command = 0;
+    slipping = islipping;
+    steps = 0;
+  }
+
+  void left(double ispeed) override { left_command = ispeed; }
+  void right(double ispeed) override { right_command = ispeed; }
+
+  // Runs between the controller's steps
+  void move() {
+    double gearset = toUnderlyingType(AbstractMotor::gearset::green);
+    double l = left_command * gearset / rpm_per_mps, r = right_command * gearset / rpm_per_mps;
+    if (slipping && steps >= SLIP_START && steps < SLIP_END) l *= SLIP;
+    double v = (l + r) / 2, w = (l - r) / TRACK;
+    x += v * std::cos(theta + w * DT / 2) * DT;
+    y += v * std::sin(theta + w * DT / 2) * DT;
+    theta += w * DT;
+    steps++;
+  }
+
+  OdomState getState(const StateMode & = StateMode::FRAME_TRANSFORMATION) const override {
+    return {x * meter, y * meter, theta * radian};
+  }
+  void setState(const OdomState &, const StateMode & = StateMode::FRAME_TRANSFORMATION) override {}
+  void setScales(const ChassisScales &) override {}
+  void step() override {}
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override { return nullptr; }
+  ChassisScales getScales() override { return ChassisScales({4_in, TRACK * meter}, 900); }
+
+  // Unused by the path loop
+  void forward(double) override {}
+  void driveVector(double, double) override {}
+  void driveVectorVoltage(double, double) override {}
+  void rotate(double) override {}
+  void stop() override {}
+  void tank(double, double, double) override {}
+  void arcade(double, double, double) override {}
+  void curvature(double, double, double) override {}
+  void resetSensors() override {}
+  void setBrakeMode(AbstractMotor::brakeMode) override {}
+  void setEncoderUnits(AbstractMotor::encoderUnits) override {}
+  void setGearing(AbstractMotor::gearset) override {}
+  void setMaxVelocity(double) override {}
+  double getMaxVelocity() const override { return 0; }
+  void setMaxVoltage(double) override {}
+  double getMaxVoltage() const override { return 0; }
+  std::valarray<std::int32_t> getSensorVals() const override { return {}; }
+};
+
+// Steps the drive instead of waiting
+struct SimRate : AbstractRate {
+  SimDrive &drive;
+  explicit SimRate(SimDrive &idrive) : drive(idrive) {}
+  void delay(QFrequency) override { drive.move(); }
+  void delayUntil(QTime) override { drive.move(); }
+  void delayUntil(uint32_t) override { drive.move(); }
+};
+
+// Runs the path loop in this thread, without the controller's task
+struct Follower : AsyncFlatMotionProfileController {
+  using AsyncFlatMotionProfileController::AsyncFlatMotionProfileController;
+
+  PathStore::Handle add(const std::vector<squiggles::ProfilePoint> &ipath, PathFollower ifollower) {
+    return store.add(ipath, DT, ifollower);
+  }
+
+  PathStore::Span get(PathStore::Handle ihandle) const { return store.get(ihandle); }
+
+  double rpm_per_mps() const { return store.convertLinearToRotational(1 * mps); }
+
+  void follow(AbstractRate &irate) { executeSinglePath(irate); }
+};
+
+// How far the drive ends from where the path ends when followed from the drive's start
+double final_error(const SimDrive &drive, const PathStore::Span &span, bool backwards, bool mirrored) {
+  const auto &last = span.points[span.size - 1];
+  double x = backwards ? -last.x : last.x, y = mirrored ? -last.y : last.y;
+  double goal_x = START_X + x * std::cos(START_THETA) - y * std::sin(START_THETA);
+  double goal_y = START_Y + x * std::sin(START_THETA) + y * std::cos(START_THETA);
+  return std::hypot(drive.x - goal_x, drive.y - goal_y);
+}
+}  // namespace
+
+int main() {
+  TimeUtil time_util(Supplier<std::unique_ptr<AbstractTimer>>([] { return std::unique_ptr<AbstractTimer>(); }),
+                     Supplier<std::unique_ptr<AbstractRate>>([] { return std::unique_ptr<AbstractRate>(); }),
+                     Supplier<std::unique_ptr<SettledUtil>>([] { return std::unique_ptr<SettledUtil>(); }));
+  auto drive = std::make_shared<SimDrive>();
+  Follower follower(time_util, {1, 2, 10}, drive, ChassisScales({4_in, TRACK * meter}, 900),
+                    AbstractMotor::GearsetRatioPair(AbstractMotor::gearset::green), std::make_shared<Logger>());
+  follower.setOdometry(drive);
+  drive->rpm_per_mps = follower.rpm_per_mps();
+
+  std::vector<squiggles::ProfilePoint> s_curve;
+  for (int i = 0; i < 300; i++) {
+    double t = i * DT, v = std::min({1.0, t * 2, (3 - t) * 2}), w = 1.2 * std::sin(t * 2);
+    s_curve.emplace_back(squiggles::ControlVector(), std::vector<double>{v + w * TRACK / 2, v - w * TRACK / 2}, 0,
+                         t);
+  }
+  PathStore::Handle paths[] = {follower.add(s_curve, PathFollower::openLoop),
+                               follower.add(s_curve, PathFollower::ramsete)};
+
+  printf("%-20s %14s %14s %14s %14s\n", "", "open-loop", "ramsete", "open-loop", "ramsete");
+  printf("%-20s %14s %14s %14s %14s\n", "", "no slip (m)", "no slip (m)", "slip (m)", "slip (m)");
+  bool ok = true;
+  for (bool backwards : {false, true}) {
+    for (bool mirrored : {false, true}) {
+      double error[2][2];  // [slipping][ramsete]
+      for (bool slipping : {false, true}) {
+        for (int ramsete : {0, 1}) {
+          drive->reset(slipping);
+          follower.setTarget(paths[ramsete], backwards, mirrored);
+          SimRate rate(*drive);
+          follower.follow(rate);
+          error[slipping][ramsete] = final_error(*drive, follower.get(paths[ramsete]), backwards, mirrored);
+        }
+      }
+
+      char name[32];
+      snprintf(name, sizeof(name), "%s%s", backwards ? "backwards" : "forwards", mirrored ? ", mirrored" : "");
+      printf("%-20s %14.3f %14.3f %14.3f %14.3f\n", name, error[0][0], error[0][1], error[1][0], error[1][1]);
+      ok = error[0][1] < 0.01 && error[1][1] * 3 < error[1][0] && ok;
+    }
+  }
+  printf(ok ? "ok\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// Host decoder for the binary telemetry stream (see include/telemetry_codec.hpp).
+//
+// Build:  g++ -std=c++17 -O2 -Iinclude tools/telemetry_decode.cpp -o telemetry_decode
+// Use:    telemetry_decode /dev/ttyACM1 run1
+//         telemetry_decode capture.bin run1
+//
+// Writes one CSV per stream, run1_<stream>.csv, with a time_ms column followed by one column per
+// field.  Reads stdin when no input is given.
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "telemetry_codec.hpp"
+
+int main(int argc, char **argv) {
+  FILE *in = argc > 1 && std::string(argv[1]) != "-" ? fopen(argv[1], "rb") : stdin;
+  std::string prefix = argc > 2 ? argv[2] : "telemetry";
+  if (in == nullptr) {
+    fprintf(stderr, "could not open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::map<std::uint8_t, FILE *> files;
+  std::uint32_t records = 0;
+
+  telemetry::codec::Decoder decoder;
+  decoder.on_schema = [&](std::uint8_t stream, const telemetry::codec::Decoder::Schema &schema) {
+    // A new schema for a stream that already has a file starts a new file
+    if (files.count(stream)) fclose(files[stream]);
+    std::string name = prefix + "_" + schema.name + ".csv";
+    if (files.count(stream)) name = prefix + "_" + schema.name + "_" + std::to_string(records) + ".csv";
+
+    FILE *out = fopen(name.c_str(), "w");
+    if (out == nullptr) {
+      fprintf(stderr, "could not open %s\n", name.c_str());
+      files.erase(stream);
+      return;
+    }
+    fprintf(out, "time_ms");
+    for (const std::string &field : schema.fields) fprintf(out, ",%s", field.c_str());
+    fprintf(out, "\n");
+    files[stream] = out;
+    fprintf(stderr, "stream %d: %s -> %s\n", stream, schema.name.c_str(), name.c_str());
+  };
+  decoder.on_record = [&](std::uint8_t stream, std::uint32_t time_ms, const std::vector<double> &values) {
+    auto it = files.find(stream);
+    if (it == files.end()) return;
+    fprintf(it->second, "%u", time_ms);
+    for (double value : values) fprintf(it->second, ",%g", value);
+    fprintf(it->second, "\n");
+    records++;
+  };
+
+  std::uint8_t buffer[4096];
+  std::size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) decoder.feed(buffer, n);
+
+  for (auto &file : files) fclose(file.second);
+  fprintf(stderr, "%u records, %u bad frames, %u lost frames\n", records, decoder.bad_frames, decoder.lost_frames);
+  return 0;
+}